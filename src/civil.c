@@ -0,0 +1,30 @@
+/**
+ * @file civil.c
+ * @brief Epoch-to-civil conversion
+ */
+
+#define _GNU_SOURCE
+#include <string.h>
+
+#include "civil.h"
+
+void
+civil_tm_get(int64_t t, int32_t utoff, struct tm *tm)
+{
+    Civil_Fields f;
+    uint32_t z, secs;
+
+    civil_split(t + utoff, &z, &secs);
+    civil_fields_get(z, secs, &f);
+
+    memset(tm, 0, sizeof(*tm));
+    tm->tm_year = f.year - 1900;
+    tm->tm_mon = f.month - 1;
+    tm->tm_mday = f.day;
+    tm->tm_yday = f.yday;
+    tm->tm_wday = f.wday;
+    tm->tm_hour = f.hour;
+    tm->tm_min = f.min;
+    tm->tm_sec = f.sec;
+    tm->tm_gmtoff = utoff;
+}
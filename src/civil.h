@@ -0,0 +1,153 @@
+/**
+ * @file civil.h
+ * @brief Proleptic Gregorian calendar arithmetic on day numbers
+ *
+ * Days are counted from 1970-01-01. The conversions are branch-light
+ * integer formulas (after Howard Hinnant's days_from_civil), valid for
+ * any year that fits the types.
+ *
+ * civil_split() and civil_fields_get() are the same arithmetic in 32-bit
+ * lanes without data-dependent branches, for vectorized loops such as
+ * civil_batch.h. They and civil_tm_get() are valid for years -999,999
+ * to 999,999.
+ */
+
+#ifndef CIVIL_H
+#define CIVIL_H
+
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * @brief Day number of year @p y, month @p m (1-12), day @p d (1-31)
+ */
+static inline int64_t
+civil_days_from(int64_t y, unsigned m, unsigned d)
+{
+    int64_t era;
+    unsigned yoe, doy, doe;
+
+    y -= m <= 2;
+    era = (y >= 0 ? y : y - 399) / 400;
+    yoe = (unsigned)(y - era * 400);
+    doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return era * 146097 + (int64_t)doe - 719468;
+}
+
+/**
+ * @brief Year, month (1-12) and day (1-31) of day number @p z
+ */
+static inline void
+civil_from_days(int64_t z, int64_t *y, unsigned *m, unsigned *d)
+{
+    int64_t era;
+    unsigned doe, yoe, doy, mp;
+
+    z += 719468;
+    era = (z >= 0 ? z : z - 146096) / 146097;
+    doe = (unsigned)(z - era * 146097);
+    yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    mp = (5 * doy + 2) / 153;
+
+    *d = doy - (153 * mp + 2) / 5 + 1;
+    *m = mp < 10 ? mp + 3 : mp - 9;
+    *y = (int64_t)yoe + era * 400 + (*m <= 2);
+}
+
+/**
+ * @brief Weekday of day number @p z, 0 for Sunday
+ */
+static inline unsigned
+civil_weekday(int64_t z)
+{
+    // 1970-01-01 was a Thursday
+    return (unsigned)(z >= -4 ? (z + 4) % 7 : (z + 5) % 7 + 6);
+}
+
+/**
+ * @brief Day number containing epoch second @p t, rounding towards the past
+ */
+static inline int64_t
+civil_days_of(int64_t t)
+{
+    return (t >= 0 ? t : t - 86399) / 86400;
+}
+
+/**
+ * @brief Civil fields of one instant, as civil_fields_get() produces them
+ */
+typedef struct _Civil_Fields {
+    int32_t year;
+    uint32_t month;     // 1-12
+    uint32_t day;       // 1-31
+    uint32_t yday;      // 0-365, from January 1st
+    uint32_t wday;      // 0-6, from Sunday
+    uint32_t hour, min, sec;
+} Civil_Fields;
+
+// Days are shifted by a whole number of 400-year eras so the kernel
+// only ever sees non-negative values and can use unsigned 32-bit math
+#define CIVIL_ERA_BIAS   2500               // 1,000,000 years
+#define CIVIL_DAY_BIAS   (719468 + 146097 * CIVIL_ERA_BIAS)
+#define CIVIL_YEAR_BIAS  (400 * CIVIL_ERA_BIAS)
+#define CIVIL_WDAY_BIAS  ((4 + 7 - CIVIL_DAY_BIAS % 7) % 7)   // 1970-01-01 was a Thursday
+
+/**
+ * @brief Splits a local epoch second into a biased day number and the second of day
+ */
+static inline void
+civil_split(int64_t local, uint32_t *z, uint32_t *secs)
+{
+    int64_t days = local / 86400;
+    int64_t rem = local - days * 86400;
+
+    // Floor division
+    days -= rem < 0;
+    rem += (rem < 0) * 86400;
+
+    *z = (uint32_t)(days + CIVIL_DAY_BIAS);
+    *secs = (uint32_t)rem;
+}
+
+/**
+ * @brief Civil fields of a biased day number and second of day
+ *
+ * Only 32-bit arithmetic and no data-dependent branches (the selects
+ * compile to conditional moves or vector blends), so the batch loop
+ * around it vectorizes.
+ */
+static inline void
+civil_fields_get(uint32_t z, uint32_t secs, Civil_Fields *f)
+{
+    uint32_t era, doe, yoe, doy, mp, m, y, leap;
+
+    era = z / 146097;
+    doe = z - era * 146097;
+    yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    mp = (5 * doy + 2) / 153;
+    m = mp + 3 - 12 * (mp >= 10);
+    y = yoe + era * 400 + (m <= 2);
+    leap = (y % 4 == 0) & ((y % 100 != 0) | (y % 400 == 0));
+
+    f->year = (int32_t)y - CIVIL_YEAR_BIAS;
+    f->month = m;
+    f->day = doy - (153 * mp + 2) / 5 + 1;
+    f->yday = doy + 59 + leap - (mp >= 10) * (365 + leap);  // doy counts from March 1st
+    f->wday = (z + CIVIL_WDAY_BIAS) % 7;
+    f->hour = secs / 3600;
+    f->min = secs / 60 % 60;
+    f->sec = secs % 60;
+}
+
+/**
+ * @brief gmtime_r() of @p t shifted by @p utoff, with tm_gmtoff set
+ *
+ * tm_isdst and tm_zone are left for the caller.
+ */
+void civil_tm_get(int64_t t, int32_t utoff, struct tm *tm);
+
+#endif /* CIVIL_H */
@@ -0,0 +1,104 @@
+/**
+ * @file civil_batch.c
+ * @brief Batch epoch-to-civil conversion
+ */
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+
+#include "civil_batch.h"
+
+#define CIVIL_ALIGN 64                      // Cache line, and wide enough for any vector unit
+
+Civil_Batch *
+civil_batch_new(int capacity)
+{
+    Civil_Batch *b;
+    size_t n, size;
+    char *p;
+
+    if (capacity < 1) capacity = 1;
+
+    // Pad every array to whole cache lines so each one starts aligned
+    n = ((size_t)capacity + CIVIL_ALIGN - 1) & ~(size_t)(CIVIL_ALIGN - 1);
+    size = n * (sizeof(int64_t) + sizeof(int32_t) * 4 + sizeof(uint16_t) + sizeof(uint8_t) * 6);
+
+    b = calloc(1, sizeof(Civil_Batch));
+    if (!b) return NULL;
+    if (posix_memalign(&b->mem, CIVIL_ALIGN, size)) {
+        free(b);
+        return NULL;
+    }
+
+    p = b->mem;
+    b->epoch = (int64_t *)p;   p += n * sizeof(int64_t);
+    b->utoff = (int32_t *)p;   p += n * sizeof(int32_t);
+    b->year = (int32_t *)p;    p += n * sizeof(int32_t);
+    b->zday = (uint32_t *)p;   p += n * sizeof(uint32_t);
+    b->secs = (uint32_t *)p;   p += n * sizeof(uint32_t);
+    b->yday = (uint16_t *)p;   p += n * sizeof(uint16_t);
+    b->month = (uint8_t *)p;   p += n;
+    b->day = (uint8_t *)p;     p += n;
+    b->wday = (uint8_t *)p;    p += n;
+    b->hour = (uint8_t *)p;    p += n;
+    b->min = (uint8_t *)p;     p += n;
+    b->sec = (uint8_t *)p;
+    b->capacity = capacity;
+
+    return b;
+}
+
+void
+civil_batch_free(Civil_Batch *b)
+{
+    if (!b) return;
+
+    free(b->mem);
+    free(b);
+}
+
+/**
+ * @brief First pass - the only 64-bit work
+ */
+static void
+_civil_split_pass(int count, const int64_t *restrict epoch, const int32_t *restrict utoff,
+                  uint32_t *restrict zday, uint32_t *restrict secs)
+{
+    for (int i = 0; i < count; i++)
+        civil_split(epoch[i] + utoff[i], &zday[i], &secs[i]);
+}
+
+/**
+ * @brief Second pass - every field, in 32-bit lanes
+ *
+ * The restrict parameters tell the compiler the arrays never overlap,
+ * which it needs to vectorize the loop.
+ */
+static void
+_civil_fields_pass(int count, const uint32_t *restrict zday, const uint32_t *restrict secs,
+                   int32_t *restrict year, uint16_t *restrict yday,
+                   uint8_t *restrict month, uint8_t *restrict day, uint8_t *restrict wday,
+                   uint8_t *restrict hour, uint8_t *restrict min, uint8_t *restrict sec)
+{
+    Civil_Fields f;
+
+    for (int i = 0; i < count; i++) {
+        civil_fields_get(zday[i], secs[i], &f);
+        year[i] = f.year;
+        yday[i] = f.yday;
+        month[i] = f.month;
+        day[i] = f.day;
+        wday[i] = f.wday;
+        hour[i] = f.hour;
+        min[i] = f.min;
+        sec[i] = f.sec;
+    }
+}
+
+void
+civil_batch_convert(Civil_Batch *b)
+{
+    _civil_split_pass(b->count, b->epoch, b->utoff, b->zday, b->secs);
+    _civil_fields_pass(b->count, b->zday, b->secs, b->year, b->yday,
+                       b->month, b->day, b->wday, b->hour, b->min, b->sec);
+}
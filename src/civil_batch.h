@@ -0,0 +1,58 @@
+/**
+ * @file civil_batch.h
+ * @brief Many epoch-to-civil conversions at once
+ *
+ * civil_batch_convert() applies civil.h's arithmetic to many instants,
+ * e.g. one per zone of a world clock grid, laid out as one array per
+ * field so the loop vectorizes. Not linked into the gadget, which only
+ * ever converts one instant per tick; the benchmark measures it.
+ */
+
+#ifndef CIVIL_BATCH_H
+#define CIVIL_BATCH_H
+
+#include "civil.h"
+
+/**
+ * @brief Structure-of-arrays batch of conversions
+ *
+ * Fill epoch[] and utoff[] for the first count entries, then call
+ * civil_batch_convert(). Every array is cache-line aligned.
+ */
+typedef struct _Civil_Batch {
+    int count;          // Entries to convert
+    int capacity;
+
+    /* In */
+    int64_t *epoch;     // Seconds since 1970-01-01 UTC
+    int32_t *utoff;     // UTC offset in effect, seconds east
+
+    /* Out */
+    int32_t *year;
+    uint16_t *yday;
+    uint8_t *month, *day, *wday;
+    uint8_t *hour, *min, *sec;
+
+    /* Between the two passes of civil_batch_convert() */
+    uint32_t *zday;     // Day number, shifted to be non-negative
+    uint32_t *secs;     // Second of the day
+
+    void *mem;          // Backing allocation of all the arrays
+} Civil_Batch;
+
+/**
+ * @brief Allocates a batch for up to @p capacity conversions
+ */
+Civil_Batch *civil_batch_new(int capacity);
+
+/**
+ * @brief Releases a batch
+ */
+void civil_batch_free(Civil_Batch *b);
+
+/**
+ * @brief Converts entries [0, count) of a batch to local civil fields
+ */
+void civil_batch_convert(Civil_Batch *b);
+
+#endif /* CIVIL_BATCH_H */
@@ -0,0 +1,275 @@
+/**
+ * @file config.c
+ * @brief Persistent settings and the config.eet store
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "mode.h"
+
+#define CONFIG_TMP_SUFFIX ".tmp"
+
+/**
+ * @brief Creates EET data descriptor for one clock's settings
+ */
+static Eet_Data_Descriptor *
+_config_clock_descriptor_new(void)
+{
+    Eet_Data_Descriptor_Class eddc;
+    Eet_Data_Descriptor *edd;
+
+    EET_EINA_STREAM_DATA_DESCRIPTOR_CLASS_SET(&eddc, Config_Clock);
+    edd = eet_data_descriptor_stream_new(&eddc);
+
+    EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Config_Clock, "show_date", show_date, EET_T_UCHAR);
+    EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Config_Clock, "clock_mode", clock_mode, EET_T_INT);
+    EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Config_Clock, "win_x", win_x, EET_T_INT);
+    EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Config_Clock, "win_y", win_y, EET_T_INT);
+    EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Config_Clock, "output", output, EET_T_STRING);
+    EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Config_Clock, "output_x", output_x, EET_T_INT);
+    EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Config_Clock, "output_y", output_y, EET_T_INT);
+    EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Config_Clock, "time_format", time_format, EET_T_STRING);
+    EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Config_Clock, "date_format", date_format, EET_T_STRING);
+
+    return edd;
+}
+
+/**
+ * @brief Creates EET data descriptor for configuration
+ */
+static Eet_Data_Descriptor *
+_config_descriptor_new(Eet_Data_Descriptor *clock_edd)
+{
+    Eet_Data_Descriptor_Class eddc;
+    Eet_Data_Descriptor *edd;
+
+    EET_EINA_STREAM_DATA_DESCRIPTOR_CLASS_SET(&eddc, Config);
+    edd = eet_data_descriptor_stream_new(&eddc);
+
+    // Single-clock layout, same keys as before the clock list existed
+    EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Config, "show_date", legacy.show_date, EET_T_UCHAR);
+    EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Config, "clock_mode", legacy.clock_mode, EET_T_INT);
+    EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Config, "win_x", legacy.win_x, EET_T_INT);
+    EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Config, "win_y", legacy.win_y, EET_T_INT);
+    EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Config, "output", legacy.output, EET_T_STRING);
+    EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Config, "output_x", legacy.output_x, EET_T_INT);
+    EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Config, "output_y", legacy.output_y, EET_T_INT);
+    EET_DATA_DESCRIPTOR_ADD_LIST(edd, Config, "clocks", clocks, clock_edd);
+
+    return edd;
+}
+
+void
+config_store_init(Config_Store *cs)
+{
+    memset(cs, 0, sizeof(*cs));
+    cs->clock_edd = _config_clock_descriptor_new();
+    cs->edd = _config_descriptor_new(cs->clock_edd);
+}
+
+void
+config_store_descriptors_free(Config_Store *cs)
+{
+    if (cs->edd) {
+        eet_data_descriptor_free(cs->edd);
+        cs->edd = NULL;
+    }
+    if (cs->clock_edd) {
+        eet_data_descriptor_free(cs->clock_edd);
+        cs->clock_edd = NULL;
+    }
+}
+
+/**
+ * @brief Drops the read handle and the mapping
+ */
+static void
+_config_store_unmap(Config_Store *cs)
+{
+    if (cs->ef) {
+        eet_close(cs->ef);
+        cs->ef = NULL;
+    }
+    if (cs->file) {
+        eina_file_close(cs->file);
+        cs->file = NULL;
+    }
+}
+
+void
+config_store_map(Config_Store *cs, const char *path)
+{
+    _config_store_unmap(cs);
+
+    cs->file = eina_file_open(path, EINA_FALSE);
+    if (!cs->file) return;
+
+    cs->ef = eet_mmap(cs->file);
+    if (!cs->ef) {
+        eina_file_close(cs->file);
+        cs->file = NULL;
+    }
+}
+
+void
+config_store_close(Config_Store *cs)
+{
+    _config_store_unmap(cs);
+    config_clear(&cs->written);
+    cs->written_valid = EINA_FALSE;
+}
+
+void
+config_store_written_set(Config_Store *cs, const Config *config)
+{
+    config_copy(&cs->written, config);
+    cs->written_valid = EINA_TRUE;
+}
+
+Config *
+config_store_load(Config_Store *cs)
+{
+    Config *config;
+
+    if (!cs->ef) return NULL;
+
+    config = eet_data_read(cs->ef, cs->edd, "config");
+    if (!config) return NULL;
+
+    // Remember the file as it is, so the next flush upgrades it
+    config_store_written_set(cs, config);
+
+    if (!config->clocks) {
+        Config_Clock *cc = calloc(1, sizeof(Config_Clock));
+
+        if (cc) {
+            config_clock_copy(cc, &config->legacy);
+            config->clocks = eina_list_append(config->clocks, cc);
+        }
+    }
+
+    return config;
+}
+
+Eina_Bool
+config_store_unchanged(const Config_Store *cs, const Config *config)
+{
+    const Eina_List *la = cs->written.clocks, *lb = config->clocks;
+
+    if (!cs->written_valid) return EINA_FALSE;
+
+    for (; la && lb; la = eina_list_next(la), lb = eina_list_next(lb)) {
+        if (!config_clock_equal(eina_list_data_get(la), eina_list_data_get(lb))) return EINA_FALSE;
+    }
+
+    return !la && !lb;
+}
+
+Eina_Bool
+config_write(const char *path, Eet_Data_Descriptor *edd, const Config *config)
+{
+    char tmp_path[PATH_MAX];
+    Eet_File *ef;
+    int ok;
+
+    snprintf(tmp_path, sizeof(tmp_path), "%s" CONFIG_TMP_SUFFIX, path);
+
+    ef = eet_open(tmp_path, EET_FILE_MODE_WRITE);
+    if (!ef) return EINA_FALSE;
+
+    ok = eet_data_write(ef, edd, "config", config, EINA_TRUE);
+    if (eet_close(ef) != 0) ok = 0;
+
+    if (!ok || rename(tmp_path, path) < 0) {
+        unlink(tmp_path);
+        return EINA_FALSE;
+    }
+
+    return EINA_TRUE;
+}
+
+Config_Clock *
+config_clock_new(Config *config)
+{
+    Config_Clock *last = eina_list_last_data_get(config->clocks);
+    Config_Clock *cc = calloc(1, sizeof(Config_Clock));
+
+    if (!cc) return NULL;
+    cc->show_date = EINA_TRUE;
+    cc->clock_mode = MODE_LOCAL; // Default to local time
+    if (last) {
+        cc->win_x = last->win_x + 32;
+        cc->win_y = last->win_y + 32;
+    }
+    config->clocks = eina_list_append(config->clocks, cc);
+
+    return cc;
+}
+
+void
+config_clock_copy(Config_Clock *dst, const Config_Clock *src)
+{
+    eina_stringshare_replace(&dst->output, src->output);
+    eina_stringshare_replace(&dst->time_format, src->time_format);
+    eina_stringshare_replace(&dst->date_format, src->date_format);
+    dst->show_date = src->show_date;
+    dst->clock_mode = src->clock_mode;
+    dst->win_x = src->win_x;
+    dst->win_y = src->win_y;
+    dst->output_x = src->output_x;
+    dst->output_y = src->output_y;
+}
+
+Eina_Bool
+config_clock_equal(const Config_Clock *a, const Config_Clock *b)
+{
+    return a->show_date == b->show_date && a->clock_mode == b->clock_mode &&
+           a->win_x == b->win_x && a->win_y == b->win_y &&
+           a->output == b->output && a->output_x == b->output_x && a->output_y == b->output_y &&
+           a->time_format == b->time_format && a->date_format == b->date_format;
+}
+
+void
+config_clock_free(Config_Clock *cc)
+{
+    eina_stringshare_del(cc->output);
+    eina_stringshare_del(cc->time_format);
+    eina_stringshare_del(cc->date_format);
+    free(cc);
+}
+
+void
+config_clear(Config *config)
+{
+    Config_Clock *cc;
+
+    EINA_LIST_FREE(config->clocks, cc)
+        config_clock_free(cc);
+    eina_stringshare_del(config->legacy.output);
+    eina_stringshare_del(config->legacy.time_format);
+    eina_stringshare_del(config->legacy.date_format);
+    memset(config, 0, sizeof(*config));
+}
+
+void
+config_copy(Config *dst, const Config *src)
+{
+    const Eina_List *l;
+    const Config_Clock *cc;
+
+    config_clear(dst);
+    config_clock_copy(&dst->legacy, &src->legacy);
+
+    EINA_LIST_FOREACH(src->clocks, l, cc) {
+        Config_Clock *copy = calloc(1, sizeof(Config_Clock));
+
+        if (!copy) break;
+        config_clock_copy(copy, cc);
+        dst->clocks = eina_list_append(dst->clocks, copy);
+    }
+}
@@ -0,0 +1,147 @@
+/**
+ * @file config.h
+ * @brief Persistent settings and the config.eet store
+ *
+ * Settings live in a single Eet entry, read through a memory-mapped
+ * handle and written to a temporary file renamed into place. None of
+ * this touches the main loop, so writes can run on a worker thread.
+ */
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <Eina.h>
+#include <Eet.h>
+
+/**
+ * @brief Persistent settings of one hosted clock
+ */
+typedef struct _Config_Clock {
+    Eina_Bool show_date;
+    int clock_mode;     // Mode_Id
+    int win_x;          // Saved window X position
+    int win_y;          // Saved window Y position
+    const char *output; // Output owning the window (stringshare), NULL if unknown
+    int output_x;       // Window position relative to that output
+    int output_y;
+    const char *time_format;    // strftime() format (stringshare), NULL for the default
+    const char *date_format;
+} Config_Clock;
+
+/**
+ * @brief Configuration data structure for persistent settings
+ *
+ * The top-level fields are the single-clock layout of earlier versions.
+ * They are kept as a mirror of the first clock, so older builds can
+ * still read the file, and are migrated into the list on load.
+ */
+typedef struct _Config {
+    Config_Clock legacy;    // Single-clock fields, mirror of the first clock
+    Eina_List *clocks;      // Config_Clock, one per hosted clock
+} Config;
+
+/**
+ * @brief Persistent config.eet store
+ *
+ * Owns the data descriptors and a memory-mapped read handle for the life
+ * of the process, and remembers what was last written so that no-op
+ * flushes never touch the disk.
+ */
+typedef struct _Config_Store {
+    Eet_Data_Descriptor *edd;       // Built once, shared with the writer thread
+    Eet_Data_Descriptor *clock_edd; // Per-clock entries of edd's list
+    Eina_File *file;                // Mapped config.eet, NULL if it does not exist
+    Eet_File *ef;                   // Read handle on top of the mapping
+    Config written;                 // Contents of config.eet as last read or written
+    Eina_Bool written_valid;
+} Config_Store;
+
+/**
+ * @brief Builds the store's data descriptors; nothing is mapped yet
+ */
+void config_store_init(Config_Store *cs);
+
+/**
+ * @brief Frees the data descriptors
+ *
+ * Must not be called while a config_write() with them is in flight.
+ */
+void config_store_descriptors_free(Config_Store *cs);
+
+/**
+ * @brief (Re)maps @p path for reading
+ *
+ * Called at startup and after each completed write, since a write
+ * renames a new file over the mapped one.
+ */
+void config_store_map(Config_Store *cs, const char *path);
+
+/**
+ * @brief Unmaps the file and forgets what it held
+ */
+void config_store_close(Config_Store *cs);
+
+/**
+ * @brief Loads configuration from the mapped file
+ * @return A new configuration, or NULL if there is no readable file
+ *
+ * A file from a single-clock version has no clock list; its top-level
+ * settings become the first clock.
+ */
+Config *config_store_load(Config_Store *cs);
+
+/**
+ * @brief Records @p config as what the file now holds
+ */
+void config_store_written_set(Config_Store *cs, const Config *config);
+
+/**
+ * @brief Whether @p config matches what the file holds
+ *
+ * Only the clock list is compared; the single-clock fields are derived
+ * from it.
+ */
+Eina_Bool config_store_unchanged(const Config_Store *cs, const Config *config);
+
+/**
+ * @brief Writes configuration to a temporary file and renames it into place
+ *
+ * Blocking; safe on any thread. Readers never see a partially written
+ * file.
+ */
+Eina_Bool config_write(const char *path, Eet_Data_Descriptor *edd, const Config *config);
+
+/**
+ * @brief Appends a clock with default settings to a configuration
+ *
+ * New clocks are cascaded from the last one so they do not open
+ * exactly on top of each other.
+ */
+Config_Clock *config_clock_new(Config *config);
+
+/**
+ * @brief Copies one clock's settings, taking a reference on its strings
+ */
+void config_clock_copy(Config_Clock *dst, const Config_Clock *src);
+
+/**
+ * @brief Whether two clocks' settings are identical
+ */
+Eina_Bool config_clock_equal(const Config_Clock *a, const Config_Clock *b);
+
+/**
+ * @brief Releases one clock's settings
+ */
+void config_clock_free(Config_Clock *cc);
+
+/**
+ * @brief Releases everything a configuration owns, leaving it empty
+ */
+void config_clear(Config *config);
+
+/**
+ * @brief Copies a configuration, taking a reference on its strings
+ */
+void config_copy(Config *dst, const Config *src);
+
+#endif /* CONFIG_H */
@@ -0,0 +1,220 @@
+/**
+ * @file control.c
+ * @brief Local control socket
+ */
+
+#define _GNU_SOURCE
+#include <Ecore.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "control.h"
+
+#define CONTROL_BACKLOG 8
+
+/**
+ * @brief One client connection: reads a request, then writes the reply
+ */
+typedef struct _Control_Conn {
+    Control_Server *server;
+    int fd;
+    Ecore_Fd_Handler *handler;
+    Eina_Strbuf *in;        // Request received so far
+    Eina_Strbuf *out;       // Reply, once the request is complete
+    size_t out_off;         // Reply bytes already written
+} Control_Conn;
+
+struct _Control_Server {
+    int fd;
+    Ecore_Fd_Handler *handler;
+    char path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+    Control_Batch_Cb cb;
+    void *data;
+    Eina_List *conns;       // Control_Conn list
+};
+
+/**
+ * @brief Closes a connection
+ */
+static void
+_control_conn_del(Control_Conn *cc)
+{
+    Control_Server *cs = cc->server;
+
+    cs->conns = eina_list_remove(cs->conns, cc);
+    if (cc->handler) ecore_main_fd_handler_del(cc->handler);
+    close(cc->fd);
+    eina_strbuf_free(cc->in);
+    if (cc->out) eina_strbuf_free(cc->out);
+    free(cc);
+}
+
+/**
+ * @brief Splits the request into lines and runs it as one batch
+ */
+static void
+_control_conn_dispatch(Control_Conn *cc)
+{
+    char *req = eina_strbuf_string_steal(cc->in);
+    char **lines = NULL;
+    int count = 0, max = 1;
+
+    cc->out = eina_strbuf_new();
+    if (req) {
+        for (char *p = req; *p; p++) {
+            if (*p == '\n') max++;
+        }
+        lines = malloc(max * sizeof(char *));
+    }
+    if (!req || !lines) {
+        eina_strbuf_append(cc->out, "error: out of memory\n");
+    } else {
+        for (char *line = strtok(req, "\n"); line; line = strtok(NULL, "\n")) {
+            size_t n = strlen(line);
+
+            if (n && line[n - 1] == '\r') line[--n] = '\0';
+            if (!n || line[0] == '#') continue;
+            lines[count++] = line;
+        }
+        cc->server->cb(cc->server->data, lines, count, cc->out);
+    }
+
+    free(lines);
+    free(req);
+}
+
+/**
+ * @brief Connection I/O - collects the request, then drains the reply
+ */
+static Eina_Bool
+_control_conn_cb(void *data, Ecore_Fd_Handler *fd_handler EINA_UNUSED)
+{
+    Control_Conn *cc = data;
+    char buf[4096];
+    ssize_t n;
+
+    if (cc->out) {
+        size_t len = eina_strbuf_length_get(cc->out);
+
+        n = write(cc->fd, eina_strbuf_string_get(cc->out) + cc->out_off, len - cc->out_off);
+        if (n < 0 && (errno == EAGAIN || errno == EINTR)) return ECORE_CALLBACK_RENEW;
+        if (n > 0) cc->out_off += n;
+        if (n <= 0 || cc->out_off >= len) {
+            cc->handler = NULL;
+            _control_conn_del(cc);
+            return ECORE_CALLBACK_CANCEL;
+        }
+        return ECORE_CALLBACK_RENEW;
+    }
+
+    n = read(cc->fd, buf, sizeof(buf));
+    if (n < 0 && (errno == EAGAIN || errno == EINTR)) return ECORE_CALLBACK_RENEW;
+    if (n > 0) eina_strbuf_append_length(cc->in, buf, n);
+
+    if (n < 0 || eina_strbuf_length_get(cc->in) > CONTROL_REQUEST_MAX) {
+        cc->handler = NULL;
+        _control_conn_del(cc);
+        return ECORE_CALLBACK_CANCEL;
+    }
+
+    // The request ends only at end of file, so it may hold empty lines
+    if (n == 0) {
+        _control_conn_dispatch(cc);
+        ecore_main_fd_handler_active_set(cc->handler, ECORE_FD_WRITE);
+    }
+
+    return ECORE_CALLBACK_RENEW;
+}
+
+/**
+ * @brief Listening socket - accepts a new connection
+ */
+static Eina_Bool
+_control_accept_cb(void *data, Ecore_Fd_Handler *fd_handler EINA_UNUSED)
+{
+    Control_Server *cs = data;
+    Control_Conn *cc;
+    int fd;
+
+    fd = accept4(cs->fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) return ECORE_CALLBACK_RENEW;
+
+    cc = calloc(1, sizeof(Control_Conn));
+    if (!cc) {
+        close(fd);
+        return ECORE_CALLBACK_RENEW;
+    }
+    cc->server = cs;
+    cc->fd = fd;
+    cc->in = eina_strbuf_new();
+    cc->handler = ecore_main_fd_handler_add(fd, ECORE_FD_READ, _control_conn_cb, cc, NULL, NULL);
+    cs->conns = eina_list_append(cs->conns, cc);
+
+    return ECORE_CALLBACK_RENEW;
+}
+
+Control_Server *
+control_server_add(const char *path, Control_Batch_Cb cb, const void *data)
+{
+    struct sockaddr_un addr;
+    Control_Server *cs;
+    Eina_Bool bound = EINA_FALSE;
+    int err;
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Warning: Control socket path too long: %s\n", path);
+        return NULL;
+    }
+
+    cs = calloc(1, sizeof(Control_Server));
+    if (!cs) return NULL;
+    cs->cb = cb;
+    cs->data = (void *)data;
+    snprintf(cs->path, sizeof(cs->path), "%s", path);
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, cs->path, sizeof(cs->path));
+
+    cs->fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (cs->fd < 0) goto fail;
+
+    // Left behind by an instance that crashed; we hold the instance lock
+    unlink(cs->path);
+
+    if (bind(cs->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) goto fail;
+    bound = EINA_TRUE;
+    chmod(cs->path, 0600);
+    if (listen(cs->fd, CONTROL_BACKLOG) < 0) goto fail;
+
+    cs->handler = ecore_main_fd_handler_add(cs->fd, ECORE_FD_READ, _control_accept_cb, cs, NULL, NULL);
+    if (!cs->handler) goto fail;
+
+    return cs;
+
+fail:
+    err = errno;
+    if (bound) unlink(cs->path);
+    if (cs->fd >= 0) close(cs->fd);
+    fprintf(stderr, "Warning: Could not set up control socket %s: %s\n", path, strerror(err));
+    free(cs);
+    return NULL;
+}
+
+void
+control_server_del(Control_Server *cs)
+{
+    if (!cs) return;
+
+    while (cs->conns)
+        _control_conn_del(eina_list_data_get(cs->conns));
+
+    ecore_main_fd_handler_del(cs->handler);
+    close(cs->fd);
+    unlink(cs->path);
+    free(cs);
+}
@@ -0,0 +1,44 @@
+/**
+ * @file control.h
+ * @brief Local control socket
+ *
+ * A line-based protocol on a Unix socket, private to the user. A client
+ * connects, writes one command per line and shuts down its write side;
+ * only that ends the request, so it may contain empty lines. The whole
+ * request is handed over as one batch, and the reply is written back
+ * before the connection is closed. The last reply line is "ok" or
+ * starts with "error".
+ */
+
+#ifndef CONTROL_H
+#define CONTROL_H
+
+#include <Eina.h>
+
+#include "control_path.h"
+
+#define CONTROL_REQUEST_MAX (64 * 1024)   // Larger requests are refused
+
+typedef struct _Control_Server Control_Server;
+
+/**
+ * @brief Handles one request
+ * @param lines The request's non-empty lines, without line terminators.
+ * @param reply Buffer to append the reply to.
+ */
+typedef void (*Control_Batch_Cb)(void *data, char **lines, int count, Eina_Strbuf *reply);
+
+/**
+ * @brief Starts listening on @p path, replacing any stale socket there
+ * @return The server, or NULL if the socket could not be set up
+ *
+ * The caller must hold the instance lock, so no live socket is replaced.
+ */
+Control_Server *control_server_add(const char *path, Control_Batch_Cb cb, const void *data);
+
+/**
+ * @brief Stops listening, drops open connections and removes the socket
+ */
+void control_server_del(Control_Server *cs);
+
+#endif /* CONTROL_H */
@@ -0,0 +1,38 @@
+/**
+ * @file control_path.h
+ * @brief Where the local control socket lives
+ *
+ * Shared by the clock and by clock-gadget-ctl, which links nothing but
+ * libc; keep this header free of EFL.
+ */
+
+#ifndef CONTROL_PATH_H
+#define CONTROL_PATH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CONTROL_SOCKET_NAME "elive-clock.sock"
+
+/**
+ * @brief Builds the control socket path
+ *
+ * Lives in $XDG_RUNTIME_DIR when set, otherwise next to config.eet.
+ */
+static inline void
+control_socket_path_get(char *path, size_t len)
+{
+    const char *dir = getenv("XDG_RUNTIME_DIR");
+    const char *home;
+
+    if (dir && dir[0]) {
+        snprintf(path, len, "%s/" CONTROL_SOCKET_NAME, dir);
+        return;
+    }
+
+    home = getenv("HOME");
+    if (!home) home = "/tmp";
+    snprintf(path, len, "%s/.config/elive-clock/" CONTROL_SOCKET_NAME, home);
+}
+
+#endif /* CONTROL_PATH_H */
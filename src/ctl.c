@@ -0,0 +1,125 @@
+/**
+ * @file ctl.c
+ * @brief clock-gadget-ctl - command-line client for the clock's control socket
+ *
+ * Sends all of its arguments, or its standard input, as one batch and
+ * prints the reply. Exits non-zero unless the batch succeeded.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "control_path.h"
+
+/**
+ * @brief Prints help message
+ */
+static void
+_print_help(const char *prog_name)
+{
+    printf("Usage: %s COMMAND...\n", prog_name);
+    printf("       %s -          (read commands from standard input)\n\n", prog_name);
+    printf("Each argument is one command; all of them are applied as one batch,\n");
+    printf("with a single redraw and a single configuration write.\n\n");
+    printf("Commands:\n");
+    printf("  clock N|all          Address clock N (from 0) or every clock; default 0\n");
+    printf("  query                Print the state of the addressed clocks\n");
+    printf("  mode local|utc|swatch|next\n");
+    printf("                       Set the display mode\n");
+    printf("  date show|hide|toggle\n");
+    printf("                       Show or hide the date\n");
+    printf("  move X Y             Move the window's top-left corner to X,Y\n");
+    printf("  reload               Re-read config.eet, dropping unsaved changes\n");
+    printf("  stats                Print runtime statistics\n");
+}
+
+/**
+ * @brief Writes a whole buffer
+ */
+static int
+_write_all(int fd, const char *buf, size_t len)
+{
+    while (len) {
+        ssize_t n = write(fd, buf, len);
+
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        buf += n;
+        len -= n;
+    }
+
+    return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+    struct sockaddr_un addr;
+    char buf[4096];
+    char *reply = NULL, *last;
+    size_t reply_len = 0;
+    ssize_t n;
+    int fd;
+
+    if (argc < 2 || !strcmp(argv[1], "--help")) {
+        _print_help(argv[0]);
+        return argc < 2;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    control_socket_path_get(addr.sun_path, sizeof(addr.sun_path));
+
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        fprintf(stderr, "ERROR: No running clock at %s: %s\n", addr.sun_path, strerror(errno));
+        return 1;
+    }
+
+    if (!strcmp(argv[1], "-")) {
+        while ((n = read(STDIN_FILENO, buf, sizeof(buf))) > 0) {
+            if (_write_all(fd, buf, n) < 0) break;
+        }
+    } else {
+        for (int i = 1; i < argc; i++) {
+            if (_write_all(fd, argv[i], strlen(argv[i])) < 0 || _write_all(fd, "\n", 1) < 0) break;
+        }
+    }
+    shutdown(fd, SHUT_WR);
+
+    while ((n = read(fd, buf, sizeof(buf))) > 0) {
+        char *grown = realloc(reply, reply_len + n + 1);
+
+        if (!grown) break;
+        reply = grown;
+        memcpy(reply + reply_len, buf, n);
+        reply_len += n;
+        reply[reply_len] = '\0';
+    }
+    close(fd);
+
+    if (!reply_len) {
+        fprintf(stderr, "ERROR: The clock closed the connection without replying\n");
+        free(reply);
+        return 1;
+    }
+
+    fwrite(reply, 1, reply_len, stdout);
+
+    // The status is the last line
+    while (reply_len && reply[reply_len - 1] == '\n') reply[--reply_len] = '\0';
+    last = strrchr(reply, '\n');
+    last = last ? last + 1 : reply;
+    n = strcmp(last, "ok") != 0;
+
+    free(reply);
+    return (int)n;
+}
@@ -0,0 +1,60 @@
+/**
+ * @file drag.c
+ * @brief Window drag decisions and geometry
+ */
+
+#include <stdlib.h>
+
+#include "drag.h"
+
+int
+drag_threshold_crossed(int dx, int dy)
+{
+    return dx * dx + dy * dy > DRAG_THRESHOLD * DRAG_THRESHOLD;
+}
+
+int
+drag_wm_wanted(int wm_drag, int has_xwin)
+{
+    return wm_drag || !has_xwin;
+}
+
+void
+drag_bounds_get(const Screen_Output *output, const Screen_Output *usable,
+                int win_w, int win_h, Drag_Bounds *b)
+{
+    const Screen_Output *u = usable;
+    int over_w = (int)(win_w * DRAG_OVERHANG);
+    int over_h = (int)(win_h * DRAG_OVERHANG);
+
+    b->min_x = u->x - (u->x == output->x ? over_w : 0);
+    b->max_x = u->x + u->w - win_w + (u->x + u->w == output->x + output->w ? over_w : 0);
+    b->min_y = u->y - (u->y == output->y ? over_h : 0);
+    b->max_y = u->y + u->h - win_h + (u->y + u->h == output->y + output->h ? over_h : 0);
+
+    // Window larger than the usable area: pin it to the top-left
+    if (b->max_x < b->min_x) b->max_x = b->min_x;
+    if (b->max_y < b->min_y) b->max_y = b->min_y;
+}
+
+void
+drag_snap(const Screen_Output *usable, int distance, int win_w, int win_h, int *x, int *y)
+{
+    const Screen_Output *u = usable;
+
+    if (distance <= 0) return;
+
+    if (abs(*x - u->x) <= distance) *x = u->x;
+    else if (abs(*x + win_w - (u->x + u->w)) <= distance) *x = u->x + u->w - win_w;
+    if (abs(*y - u->y) <= distance) *y = u->y;
+    else if (abs(*y + win_h - (u->y + u->h)) <= distance) *y = u->y + u->h - win_h;
+}
+
+void
+drag_clamp(const Drag_Bounds *b, int *x, int *y)
+{
+    if (*x < b->min_x) *x = b->min_x;
+    if (*x > b->max_x) *x = b->max_x;
+    if (*y < b->min_y) *y = b->min_y;
+    if (*y > b->max_y) *y = b->max_y;
+}
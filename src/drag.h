@@ -0,0 +1,66 @@
+/**
+ * @file drag.h
+ * @brief Window drag decisions and geometry
+ *
+ * Everything a drag decides that does not need a window: when a press
+ * becomes a drag, who runs the move loop, and where the window may end
+ * up. Kept apart from the event handlers, and free of EFL, so it can be
+ * tested without a display.
+ */
+
+#ifndef DRAG_H
+#define DRAG_H
+
+#include "screen_geometry.h"
+
+#define DRAG_THRESHOLD      5       // Pointer travel, in pixels, before a press becomes a drag
+#define DRAG_OVERHANG       0.3     // Part of the window allowed past a bare screen edge
+
+/**
+ * @brief Allowed range for the window's top-left corner
+ */
+typedef struct _Drag_Bounds {
+    int min_x, max_x;
+    int min_y, max_y;
+} Drag_Bounds;
+
+/**
+ * @brief Whether the pointer has moved far enough from the press to drag
+ * @return Non-zero once it has
+ */
+int drag_threshold_crossed(int dx, int dy);
+
+/**
+ * @brief Whether the move loop should be handed to the window manager
+ *
+ * Either because it was asked for, or because there is no X window to
+ * move ourselves (Wayland).
+ *
+ * @return Non-zero to let the window manager move the window
+ */
+int drag_wm_wanted(int wm_drag, int has_xwin);
+
+/**
+ * @brief Computes where a @p win_w x @p win_h window may be placed
+ *
+ * The window stays inside @p usable, the part of @p output not covered
+ * by panels, except that it may hang DRAG_OVERHANG of its size past an
+ * edge @p usable shares with @p output. A window larger than @p usable
+ * is pinned to its top-left.
+ */
+void drag_bounds_get(const Screen_Output *output, const Screen_Output *usable,
+                     int win_w, int win_h, Drag_Bounds *b);
+
+/**
+ * @brief Snaps a window within @p distance of an edge of @p usable onto it
+ *
+ * Each axis snaps on its own, so near a corner both do.
+ */
+void drag_snap(const Screen_Output *usable, int distance, int win_w, int win_h, int *x, int *y);
+
+/**
+ * @brief Moves a window position into @p b
+ */
+void drag_clamp(const Drag_Bounds *b, int *x, int *y);
+
+#endif /* DRAG_H */
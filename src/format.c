@@ -0,0 +1,255 @@
+/**
+ * @file format.c
+ * @brief Compiled strftime() formats
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "format.h"
+
+/**
+ * @brief Conversions with a dedicated operation
+ */
+typedef struct _Format_Conv {
+    char c;
+    uint8_t kind;
+    uint8_t arg;
+    char pad;
+    int resolution;
+} Format_Conv;
+
+static const Format_Conv _format_convs[] = {
+    { 'H', FORMAT_OP_NUM2, FORMAT_FIELD_HOUR,   '0', FORMAT_RES_MINUTE },
+    { 'k', FORMAT_OP_NUM2, FORMAT_FIELD_HOUR,   ' ', FORMAT_RES_MINUTE },
+    { 'I', FORMAT_OP_NUM2, FORMAT_FIELD_HOUR12, '0', FORMAT_RES_MINUTE },
+    { 'l', FORMAT_OP_NUM2, FORMAT_FIELD_HOUR12, ' ', FORMAT_RES_MINUTE },
+    { 'M', FORMAT_OP_NUM2, FORMAT_FIELD_MIN,    '0', FORMAT_RES_MINUTE },
+    { 'S', FORMAT_OP_NUM2, FORMAT_FIELD_SEC,    '0', FORMAT_RES_SECOND },
+    { 'd', FORMAT_OP_NUM2, FORMAT_FIELD_MDAY,   '0', FORMAT_RES_DAY },
+    { 'e', FORMAT_OP_NUM2, FORMAT_FIELD_MDAY,   ' ', FORMAT_RES_DAY },
+    { 'm', FORMAT_OP_NUM2, FORMAT_FIELD_MON,    '0', FORMAT_RES_DAY },
+    { 'y', FORMAT_OP_NUM2, FORMAT_FIELD_YEAR2,  '0', FORMAT_RES_DAY },
+    { 'Y', FORMAT_OP_YEAR, 0,                   0,   FORMAT_RES_DAY },
+    { 'A', FORMAT_OP_NAME, TABLES_NAMES_WDAY,      0, FORMAT_RES_DAY },
+    { 'a', FORMAT_OP_NAME, TABLES_NAMES_WDAY_ABBR, 0, FORMAT_RES_DAY },
+    { 'B', FORMAT_OP_NAME, TABLES_NAMES_MON,       0, FORMAT_RES_DAY },
+    { 'b', FORMAT_OP_NAME, TABLES_NAMES_MON_ABBR,  0, FORMAT_RES_DAY },
+    { 'h', FORMAT_OP_NAME, TABLES_NAMES_MON_ABBR,  0, FORMAT_RES_DAY },
+    { 'p', FORMAT_OP_NAME, TABLES_NAMES_AMPM,      0, FORMAT_RES_MINUTE },
+};
+
+// Conversions left to strftime() that still only change once a day or minute
+static const char _format_day_convs[] = "CDFGgjUuVWwxZz";
+static const char _format_minute_convs[] = "PR";
+
+/**
+ * @brief Appends bytes to the pool
+ * @return Their offset, or -1 if the pool is full
+ */
+static int
+_format_pool_add(Format *f, int *used, const char *s, size_t len)
+{
+    int off = *used;
+
+    if (off + len + 1 > FORMAT_POOL_MAX) return -1;
+    memcpy(f->pool + off, s, len);
+    f->pool[off + len] = '\0';
+    *used += (int)len + 1;
+
+    return off;
+}
+
+/**
+ * @brief Appends a literal, merging it into a literal just before it
+ */
+static Eina_Bool
+_format_literal_add(Format *f, int *used, const char *s, size_t len)
+{
+    Format_Op *last = f->count ? &f->ops[f->count - 1] : NULL;
+    int off;
+
+    // The pool ends with the previous literal and its NUL; extend it in place
+    if (last && last->kind == FORMAT_OP_LITERAL && last->off + last->len + 1 == *used &&
+        last->len + len <= UINT8_MAX) {
+        if (*used + len > FORMAT_POOL_MAX) return EINA_FALSE;
+        memcpy(f->pool + *used - 1, s, len);
+        f->pool[*used - 1 + len] = '\0';
+        *used += (int)len;
+        last->len += (uint8_t)len;
+        return EINA_TRUE;
+    }
+
+    if (f->count >= FORMAT_OPS_MAX || len > UINT8_MAX) return EINA_FALSE;
+    off = _format_pool_add(f, used, s, len);
+    if (off < 0) return EINA_FALSE;
+
+    f->ops[f->count].kind = FORMAT_OP_LITERAL;
+    f->ops[f->count].len = (uint8_t)len;
+    f->ops[f->count].off = (uint16_t)off;
+    f->count++;
+
+    return EINA_TRUE;
+}
+
+Eina_Bool
+format_compile(Format *f, const char *fmt)
+{
+    const char *p = fmt, *spec;
+    int used = 0;
+
+    memset(f, 0, sizeof(*f));
+    f->resolution = FORMAT_RES_DAY;
+    f->names = tables_locale_get();
+
+    while (*p) {
+        const Format_Conv *conv = NULL;
+        Eina_Bool plain;
+        int res = FORMAT_RES_SECOND;
+
+        if (*p != '%') {
+            size_t n = strcspn(p, "%");
+
+            if (!_format_literal_add(f, &used, p, n)) return EINA_FALSE;
+            p += n;
+            continue;
+        }
+
+        // %[flags][width][E|O]conversion
+        spec = p++;
+        plain = !strchr("_-0^#", *p) && !(*p >= '1' && *p <= '9') && *p != 'E' && *p != 'O';
+        p += strspn(p, "_-0^#");
+        p += strspn(p, "0123456789");
+        if (*p == 'E' || *p == 'O') p++;
+        if (!*p) {
+            // A lone trailing '%' is printed as is
+            if (!_format_literal_add(f, &used, spec, p - spec)) return EINA_FALSE;
+            break;
+        }
+
+        if (plain) {
+            if (*p == '%' || *p == 'n' || *p == 't') {
+                const char *text = *p == '%' ? "%" : *p == 'n' ? "\n" : "\t";
+
+                if (!_format_literal_add(f, &used, text, 1)) return EINA_FALSE;
+                p++;
+                continue;
+            }
+            for (size_t i = 0; i < sizeof(_format_convs) / sizeof(_format_convs[0]); i++) {
+                if (_format_convs[i].c == *p) conv = &_format_convs[i];
+            }
+        }
+
+        if (f->count >= FORMAT_OPS_MAX) return EINA_FALSE;
+
+        if (conv) {
+            f->ops[f->count].kind = conv->kind;
+            f->ops[f->count].arg = conv->arg;
+            f->ops[f->count].pad = conv->pad;
+            res = conv->resolution;
+        } else {
+            int off = _format_pool_add(f, &used, spec, p + 1 - spec);
+
+            if (off < 0) return EINA_FALSE;
+            f->ops[f->count].kind = FORMAT_OP_STRFTIME;
+            f->ops[f->count].off = (uint16_t)off;
+            if (strchr(_format_day_convs, *p)) res = FORMAT_RES_DAY;
+            else if (strchr(_format_minute_convs, *p)) res = FORMAT_RES_MINUTE;
+        }
+        f->count++;
+        p++;
+
+        if (res < f->resolution) f->resolution = res;
+    }
+
+    return EINA_TRUE;
+}
+
+/**
+ * @brief Value of a two-digit field
+ */
+static int
+_format_field_get(const struct tm *tm, Format_Field field)
+{
+    switch (field) {
+        case FORMAT_FIELD_HOUR: return tm->tm_hour;
+        case FORMAT_FIELD_HOUR12: return tm->tm_hour % 12 ? tm->tm_hour % 12 : 12;
+        case FORMAT_FIELD_MIN: return tm->tm_min;
+        case FORMAT_FIELD_SEC: return tm->tm_sec;
+        case FORMAT_FIELD_MDAY: return tm->tm_mday;
+        case FORMAT_FIELD_MON: return tm->tm_mon + 1;
+        case FORMAT_FIELD_YEAR2: return ((tm->tm_year + 1900) % 100 + 100) % 100;
+    }
+
+    return 0;
+}
+
+size_t
+format_exec(const Format *f, const struct tm *tm, char *buf, size_t len)
+{
+    char *p = buf, *end = buf + len - 1;    // Room for the NUL
+    const Tables_Name *name;
+    const char *src;
+    char tmp[128];
+    size_t n;
+    int v, idx;
+
+    if (!len) return 0;
+
+    for (int i = 0; i < f->count && p < end; i++) {
+        const Format_Op *op = &f->ops[i];
+
+        switch (op->kind) {
+            case FORMAT_OP_LITERAL:
+                src = f->pool + op->off;
+                n = op->len;
+                break;
+            case FORMAT_OP_NUM2:
+                v = _format_field_get(tm, op->arg);
+                if (v < 0 || v > 99) v = 0;
+                if (end - p < 2) {
+                    end = p;    // No half fields; the output stops here
+                    continue;
+                }
+                tables_num2_put(p, v, op->pad);
+                p += 2;
+                continue;
+            case FORMAT_OP_YEAR:
+                v = tm->tm_year + 1900;
+                if (v >= 1000 && v <= 9999 && end - p >= 4) {
+                    tables_num2_put(p, v / 100, '0');
+                    tables_num2_put(p + 2, v % 100, '0');
+                    p += 4;
+                    continue;
+                }
+                n = snprintf(p, end - p + 1, "%d", v);
+                p += n < (size_t)(end - p) ? n : (size_t)(end - p);
+                continue;
+            case FORMAT_OP_NAME:
+                idx = op->arg == TABLES_NAMES_AMPM ? tm->tm_hour >= 12 :
+                      op->arg <= TABLES_NAMES_WDAY_ABBR ? tm->tm_wday : tm->tm_mon;
+                if (idx < 0 || idx > 11) idx = 0;
+                name = &f->names->names[op->arg][idx];
+                src = name->text;
+                n = name->len;
+                break;
+            default:
+                n = strftime(p, end - p + 1, f->pool + op->off, tm);
+                if (n) {
+                    p += n;
+                    continue;
+                }
+                // Too long for what is left (or empty): truncate it like the others
+                n = strftime(tmp, sizeof(tmp), f->pool + op->off, tm);
+                src = tmp;
+                break;
+        }
+
+        if (n > (size_t)(end - p)) n = end - p;
+        memcpy(p, src, n);
+        p += n;
+    }
+    *p = '\0';
+
+    return p - buf;
+}
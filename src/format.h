@@ -0,0 +1,81 @@
+/**
+ * @file format.h
+ * @brief Compiled strftime() formats
+ *
+ * A format string is compiled once into a short list of operations:
+ * literal spans, two-digit fields and locale names, the last two looked
+ * up in the shared tables (see tables.h). Executing it is then a
+ * handful of copies into a fixed buffer, with no parsing, locale
+ * lookups or allocations. Conversions without a dedicated operation
+ * (modifiers, widths, rarely used ones) are kept as single-conversion
+ * strftime() calls, so output always matches strftime() for the same
+ * format.
+ */
+
+#ifndef FORMAT_H
+#define FORMAT_H
+
+#include <Eina.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "tables.h"
+
+#define FORMAT_OPS_MAX      32
+#define FORMAT_POOL_MAX     256     // Literals and strftime() specs
+
+// How often a format's output can change, in seconds
+#define FORMAT_RES_SECOND   1
+#define FORMAT_RES_MINUTE   60
+#define FORMAT_RES_DAY      86400
+
+typedef enum {
+    FORMAT_OP_LITERAL,      // Copy pool[off, off + len)
+    FORMAT_OP_NUM2,         // Two-digit field, left-padded with pad
+    FORMAT_OP_YEAR,         // Full year
+    FORMAT_OP_NAME,         // Locale name from names->names[table]
+    FORMAT_OP_STRFTIME      // strftime() of the single conversion at pool + off
+} Format_Op_Kind;
+
+typedef enum {
+    FORMAT_FIELD_HOUR,      // 00-23
+    FORMAT_FIELD_HOUR12,    // 01-12
+    FORMAT_FIELD_MIN,
+    FORMAT_FIELD_SEC,
+    FORMAT_FIELD_MDAY,
+    FORMAT_FIELD_MON,       // 01-12
+    FORMAT_FIELD_YEAR2      // Year within the century
+} Format_Field;
+
+typedef struct _Format_Op {
+    uint8_t kind;           // Format_Op_Kind
+    uint8_t arg;            // Format_Field or Tables_Names
+    char pad;               // NUM2 padding, '0' or ' '
+    uint8_t len;            // LITERAL length
+    uint16_t off;           // Pool offset
+} Format_Op;
+
+typedef struct _Format {
+    Format_Op ops[FORMAT_OPS_MAX];
+    int count;
+    int resolution;                 // FORMAT_RES_*, finest field used
+    char pool[FORMAT_POOL_MAX];
+    const Tables_Locale *names;     // Locale the format was compiled for
+} Format;
+
+/**
+ * @brief Compiles @p fmt for the current locale
+ * @return EINA_FALSE if it does not fit the fixed-size tables
+ */
+Eina_Bool format_compile(Format *f, const char *fmt);
+
+/**
+ * @brief Formats @p tm into @p buf, always NUL-terminated
+ * @return Length written, truncated to fit @p len
+ *
+ * A result that does not fit is cut to a prefix of the full text,
+ * never leaving a partial two-digit field.
+ */
+size_t format_exec(const Format *f, const struct tm *tm, char *buf, size_t len);
+
+#endif /* FORMAT_H */
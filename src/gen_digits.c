@@ -0,0 +1,39 @@
+/**
+ * @file gen_digits.c
+ * @brief Build-time generator for the 00-99 two-digit table
+ *
+ * Writes a header defining TABLES_DIGITS2 as the 200-character string
+ * "000102...99", so entry n lives at offset 2 * n.
+ */
+
+#include <stdio.h>
+
+int
+main(int argc, char **argv)
+{
+    FILE *f;
+
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s OUTPUT\n", argv[0]);
+        return 1;
+    }
+
+    f = fopen(argv[1], "w");
+    if (!f) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    fprintf(f, "/* Generated by gen_digits.c - do not edit */\n\n");
+    fprintf(f, "#ifndef DIGITS_H\n#define DIGITS_H\n\n");
+    fprintf(f, "#define TABLES_DIGITS2 \\\n");
+    for (int row = 0; row < 10; row++) {
+        fprintf(f, "    \"");
+        for (int n = row * 10; n < row * 10 + 10; n++)
+            fprintf(f, "%02d", n);
+        fprintf(f, "\"%s\n", row < 9 ? " \\" : "");
+    }
+    fprintf(f, "\n#endif /* DIGITS_H */\n");
+
+    return fclose(f) ? 1 : 0;
+}
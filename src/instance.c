@@ -0,0 +1,240 @@
+/**
+ * @file instance.c
+ * @brief Single-instance lock and launch handoff
+ */
+
+#include <Ecore.h>
+#include <Ecore_Ipc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+
+#include "instance.h"
+
+#define HANDOFF_RETRY_DELAY 0.05 // The running instance may not be listening yet
+
+/**
+ * @brief State of one handoff attempt
+ */
+typedef struct _Handoff {
+    Ecore_Ipc_Server *server;
+    Ecore_Timer *retry_timer;
+    Ecore_Timer *timeout_timer;
+    char *msg;                  // Packed command line
+    int len;
+    Eina_Bool acked;
+} Handoff;
+
+static void _handoff_connect(Handoff *h);
+
+Eina_Bool
+instance_lock(const char *path)
+{
+    int fd, err;
+
+    fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        fprintf(stderr, "Warning: Could not open instance lock %s: %s\n", path, strerror(errno));
+        return EINA_TRUE;
+    }
+
+    if (flock(fd, LOCK_EX | LOCK_NB) < 0) {
+        err = errno;
+        close(fd);
+        return err != EWOULDBLOCK;
+    }
+
+    // Deliberately never closed; the kernel drops the lock when we exit
+    return EINA_TRUE;
+}
+
+/**
+ * @brief Packs argv[1..] into one NUL-separated buffer
+ */
+static char *
+_instance_args_pack(int argc, char **argv, int *len)
+{
+    size_t total = 0;
+    char *buf, *p;
+
+    for (int i = 1; i < argc; i++) total += strlen(argv[i]) + 1;
+
+    buf = p = malloc(total + 1);
+    if (!buf) return NULL;
+
+    for (int i = 1; i < argc; i++) {
+        size_t n = strlen(argv[i]) + 1;
+        memcpy(p, argv[i], n);
+        p += n;
+    }
+
+    *len = (int)total;
+    return buf;
+}
+
+char **
+instance_args_unpack(const void *data, int size, int *argc)
+{
+    static char prog[] = "clock-gadget";
+    const char *src = data;
+    char **argv, *strs, *s;
+    int n = 1, k = 1;
+
+    if (size < 0) return NULL;
+
+    // One entry per NUL, plus an unterminated tail
+    for (int i = 0; i < size; i++) {
+        if (!src[i]) n++;
+    }
+    if (size && src[size - 1]) n++;
+
+    argv = malloc((n + 1) * sizeof(char *) + size + 1);
+    if (!argv) return NULL;
+
+    strs = (char *)(argv + n + 1);
+    if (size) memcpy(strs, src, size);
+    strs[size] = '\0';
+
+    argv[0] = prog;
+    for (s = strs; s < strs + size && k < n; s += strlen(s) + 1) argv[k++] = s;
+    argv[k] = NULL;
+
+    *argc = k;
+    return argv;
+}
+
+/**
+ * @brief Connected - send the command line
+ */
+static Eina_Bool
+_handoff_server_add_cb(void *data, int type EINA_UNUSED, void *event)
+{
+    Handoff *h = data;
+    Ecore_Ipc_Event_Server_Add *ev = event;
+
+    if (ev->server != h->server) return ECORE_CALLBACK_PASS_ON;
+
+    ecore_ipc_server_send(h->server, INSTANCE_IPC_MAJOR_ARGS, 0, 0, 0, 0, h->msg, h->len);
+    ecore_ipc_server_flush(h->server);
+
+    return ECORE_CALLBACK_PASS_ON;
+}
+
+/**
+ * @brief Reply from the running instance
+ */
+static Eina_Bool
+_handoff_server_data_cb(void *data, int type EINA_UNUSED, void *event)
+{
+    Handoff *h = data;
+    Ecore_Ipc_Event_Server_Data *ev = event;
+
+    if (ev->server != h->server) return ECORE_CALLBACK_PASS_ON;
+
+    if (ev->major == INSTANCE_IPC_MAJOR_ACK) {
+        h->acked = EINA_TRUE;
+        ecore_main_loop_quit();
+    }
+
+    return ECORE_CALLBACK_PASS_ON;
+}
+
+/**
+ * @brief Retry timer - reconnect after a refused or dropped connection
+ */
+static Eina_Bool
+_handoff_retry_cb(void *data)
+{
+    Handoff *h = data;
+
+    h->retry_timer = NULL;
+    _handoff_connect(h);
+
+    return ECORE_CALLBACK_CANCEL;
+}
+
+/**
+ * @brief Connection refused or dropped before the acknowledgement
+ */
+static Eina_Bool
+_handoff_server_del_cb(void *data, int type EINA_UNUSED, void *event)
+{
+    Handoff *h = data;
+    Ecore_Ipc_Event_Server_Del *ev = event;
+
+    if (ev->server != h->server) return ECORE_CALLBACK_PASS_ON;
+
+    ecore_ipc_server_del(h->server);
+    h->server = NULL;
+
+    if (!h->acked && !h->retry_timer) {
+        h->retry_timer = ecore_timer_add(HANDOFF_RETRY_DELAY, _handoff_retry_cb, h);
+    }
+
+    return ECORE_CALLBACK_PASS_ON;
+}
+
+/**
+ * @brief Overall timeout - give up on the running instance
+ */
+static Eina_Bool
+_handoff_timeout_cb(void *data)
+{
+    Handoff *h = data;
+
+    h->timeout_timer = NULL;
+    ecore_main_loop_quit();
+
+    return ECORE_CALLBACK_CANCEL;
+}
+
+/**
+ * @brief Connects to the running instance's socket
+ */
+static void
+_handoff_connect(Handoff *h)
+{
+    char name[] = INSTANCE_IPC_NAME;
+
+    h->server = ecore_ipc_server_connect(ECORE_IPC_LOCAL_USER, name, 0, h);
+    if (!h->server) h->retry_timer = ecore_timer_add(HANDOFF_RETRY_DELAY, _handoff_retry_cb, h);
+}
+
+Eina_Bool
+instance_handoff(int argc, char **argv, double timeout)
+{
+    Ecore_Event_Handler *handlers[3];
+    Handoff h;
+
+    memset(&h, 0, sizeof(h));
+
+    h.msg = _instance_args_pack(argc, argv, &h.len);
+    if (!h.msg) return EINA_FALSE;
+
+    if (!ecore_ipc_init()) {
+        free(h.msg);
+        return EINA_FALSE;
+    }
+
+    handlers[0] = ecore_event_handler_add(ECORE_IPC_EVENT_SERVER_ADD, _handoff_server_add_cb, &h);
+    handlers[1] = ecore_event_handler_add(ECORE_IPC_EVENT_SERVER_DATA, _handoff_server_data_cb, &h);
+    handlers[2] = ecore_event_handler_add(ECORE_IPC_EVENT_SERVER_DEL, _handoff_server_del_cb, &h);
+    h.timeout_timer = ecore_timer_add(timeout, _handoff_timeout_cb, &h);
+
+    _handoff_connect(&h);
+    ecore_main_loop_begin();
+
+    if (h.timeout_timer) ecore_timer_del(h.timeout_timer);
+    if (h.retry_timer) ecore_timer_del(h.retry_timer);
+    for (int i = 0; i < 3; i++) ecore_event_handler_del(handlers[i]);
+    if (h.server) ecore_ipc_server_del(h.server);
+    free(h.msg);
+
+    ecore_ipc_shutdown();
+
+    return h.acked;
+}
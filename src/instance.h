@@ -0,0 +1,44 @@
+/**
+ * @file instance.h
+ * @brief Single-instance lock and launch handoff
+ *
+ * The first launch takes a lock file and listens on a local IPC socket.
+ * Later launches find the lock held, forward their command line to the
+ * running instance and exit, without ever initializing Elementary.
+ */
+
+#ifndef INSTANCE_H
+#define INSTANCE_H
+
+#include <Eina.h>
+
+#define INSTANCE_IPC_NAME        "elive-clock"
+#define INSTANCE_IPC_MAJOR_ARGS  1   // Client -> instance: NUL-separated argv[1..]
+#define INSTANCE_IPC_MAJOR_ACK   2   // Instance -> client: options applied
+
+/**
+ * @brief Takes the process-wide instance lock
+ * @return EINA_TRUE if this process is the running instance
+ *
+ * The lock is held until the process exits. If the lock file cannot be
+ * opened at all, this process is assumed to be the only one.
+ */
+Eina_Bool instance_lock(const char *path);
+
+/**
+ * @brief Forwards the command line to the running instance
+ * @param timeout Seconds to wait, covering an instance that is still starting.
+ * @return EINA_TRUE once the instance has acknowledged the options
+ *
+ * Runs its own short main loop on top of Ecore_Ipc only.
+ */
+Eina_Bool instance_handoff(int argc, char **argv, double timeout);
+
+/**
+ * @brief Rebuilds an argument vector from a forwarded command line
+ * @param argc Set to the number of entries, including a placeholder argv[0].
+ * @return A NULL-terminated vector in a single allocation; free() it
+ */
+char **instance_args_unpack(const void *data, int size, int *argc);
+
+#endif /* INSTANCE_H */
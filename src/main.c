@@ -13,57 +13,185 @@
 #define _GNU_SOURCE
 #include <Elementary.h>
 #include <Ecore_X.h>
+#include <Ecore_Input.h>
+#include <Ecore_Ipc.h>
 #include <Eet.h>
 #include <time.h>
 #include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <stdint.h>
 #include <errno.h>
 
+#include "config.h"
+#include "screens.h"
+#include "instance.h"
+#include "control.h"
+#include "timepage.h"
+#include "tz.h"
+#include "format.h"
+#include "mode.h"
+#include "wheel.h"
+#include "drag.h"
+
 // Removed CONFIG_VERSION as migration code is being removed
-#define TIMER_INTERVAL_SECONDS 1.0
-#define TIMER_INTERVAL_MINUTES 60.0
+#define TICK_FALLBACK_SLACK 0.001 // Relative timers aim this far past the boundary
+
+#ifndef TFD_TIMER_CANCEL_ON_SET
+# define TFD_TIMER_CANCEL_ON_SET (1 << 1)
+#endif
 
 #define CONFIG_FILE_SUFFIX "/config.eet"
 #define CONFIG_FILE_SUFFIX_LEN (sizeof(CONFIG_FILE_SUFFIX) - 1)
+#define INSTANCE_LOCK_SUFFIX "/instance.lock"
+#define INSTANCE_LOCK_SUFFIX_LEN (sizeof(INSTANCE_LOCK_SUFFIX) - 1)
+#define INSTANCE_HANDOFF_TIMEOUT 2.0 // Max time a second launch waits for the running one
+
+#define CONFIG_FLUSH_DELAY 2.0    // Quiet period before a dirty config is written
+#define CONFIG_SHUTDOWN_WAIT 5.0  // Max time to wait for an in-flight write on exit
+
+#define WM_MOVE_SETTLE_DELAY 0.3  // Quiet period after which a WM-driven move is over
+#define SCREENS_CHANGE_DELAY 0.2  // Coalesces bursts of RandR/workarea notifications
+#define SNAP_DISTANCE_DEFAULT 16  // Pixels within which --snap pulls the window to an edge
+
+// Formats used unless --time-format/--date-format say otherwise
+#define TIME_FORMAT_SECONDS "%H:%M:%S"
+#define TIME_FORMAT_MINUTES "%H:%M"
+#define DATE_FORMAT_DEFAULT "%A, %B %d, %Y"
+
+// Text parts driven by the render stage
+typedef enum {
+    CLOCK_PART_TIME,
+    CLOCK_PART_DATE,
+    CLOCK_PART_INDICATOR,
+    CLOCK_PART_LAST
+} Clock_Part;
+
+#define RENDER_TEXT_MAX 64
+
+static const char *_clock_part_names[CLOCK_PART_LAST] = {
+    "time_text",
+    "date_text",
+    "utc_indicator_text"
+};
 
-// Clock display modes
-#define CLOCK_MODE_LOCAL  0
-#define CLOCK_MODE_UTC    1
-#define CLOCK_MODE_SWATCH 2
 
 /**
- * @brief Configuration data structure for persistent settings
+ * @brief Command-line options, given at startup or forwarded by a later launch
+ *
+ * Options that were not given stay at -1 (or EINA_FALSE), so a
+ * forwarded launch only changes what it spells out.
  */
-typedef struct _Config {
-    Eina_Bool show_date;
-    int clock_mode;     // 0 for local, 1 for UTC, 2 for Swatch
-    int win_x;          // Saved window X position
-    int win_y;          // Saved window Y position
-} Config;
+typedef struct _Options {
+    Eina_Bool debug;
+    Eina_Bool normal_window;
+    Eina_Bool show_seconds;
+    Eina_Bool wm_drag;
+    Eina_Bool help;
+    int snap_distance;
+    int beats_precision;
+    int clocks_min;
+    int clock_mode;     // --mode, applied to every clock
+    int show_date;      // --show-date (1) or --hide-date (0)
+    Eina_Bool publish_time;
+    const char *time_format;    // --time-format, "" for the default
+    const char *date_format;    // --date-format, "" for the default
+} Options;
 
 /**
- * @brief Application data structure
+ * @brief Control socket commands, parsed before any of a batch is applied
  */
-typedef struct _App_Data {
+typedef enum {
+    CONTROL_QUERY,
+    CONTROL_MODE,
+    CONTROL_DATE,
+    CONTROL_MOVE,
+    CONTROL_RELOAD,
+    CONTROL_STATS
+} Control_Op;
+
+#define CONTROL_MODE_NEXT   -2  // "mode next": cycle like a click does
+#define CONTROL_DATE_TOGGLE  2  // "date toggle"
+
+typedef struct _Control_Cmd {
+    Control_Op op;
+    int clock;      // Addressed clock index, -1 for all
+    int a, b;       // Arguments: mode, date state, or move coordinates
+} Control_Cmd;
+
+/**
+ * @brief Render stage state - last text pushed to each Edje part
+ */
+typedef struct _Render_Cache {
+    Evas_Object *edje;                              // Cached elm_layout_edje_get() handle
+    char text[CLOCK_PART_LAST][RENDER_TEXT_MAX];    // Last string pushed per part
+    Eina_Bool valid[CLOCK_PART_LAST];               // Whether text[] reflects the part
+    unsigned long updates;                          // Part updates pushed to Edje
+    unsigned long skipped;                          // Part updates skipped (unchanged)
+} Render_Cache;
+
+/**
+ * @brief Cached date string and the window during which it stays valid
+ */
+typedef struct _Date_Cache {
+    char text[RENDER_TEXT_MAX]; // Formatted date
+    int clock_mode;             // Mode the date was formatted for
+    long gmtoff;                // UTC offset in effect when formatted
+    time_t valid_from;          // Start of the day the date was formatted for
+    time_t valid_until;         // First second at which the date is stale
+    Eina_Bool valid;
+    unsigned long recomputes;   // Number of strftime() calls for the date
+} Date_Cache;
+
+/**
+ * @brief How late boundary-aligned ticks land relative to the true boundary
+ */
+typedef struct _Tick_Stats {
+    unsigned long ticks;
+    long long last_late_ns;
+    long long max_late_ns;
+    long long total_late_ns;
+    unsigned long clock_jumps;  // Realtime clock steps seen (NTP, manual set, resume)
+} Tick_Stats;
+
+/**
+ * @brief Snapshot of the configuration handed to the background writer
+ */
+typedef struct _Config_Write_Job {
+    struct _App_Data *ad;           // NULL once abandoned at shutdown
+    Eet_Data_Descriptor *edd;
+    char path[PATH_MAX];
+    Config config;
+    Eina_Bool ok;
+} Config_Write_Job;
+
+/**
+ * @brief One clock window hosted by the process
+ */
+typedef struct _Clock_Instance {
+    struct _App_Data *ad;
+    Config_Clock *config;     // Its entry in ad->config->clocks
+    Ecore_Job *close_job;     // Pending removal requested from its own callbacks
+
     /* Window and UI elements */
     Evas_Object *win;
     Evas_Object *layout;
-    Ecore_Timer *timer;
-
-    /* Configuration */
-    Config *config;
-    char *config_file;
+    Render_Cache render;
+    Date_Cache date;
+    Format time_format;       // Compiled from its config, or the default
+    Format date_format;
+    Wheel_Timer tick;         // Due the next instant its displayed time changes
 
-    /* Application state */
-    Eina_Bool debug;
-    Eina_Bool normal_window;
-    Eina_Bool show_seconds;
+    /* Clock state */
     Eina_Bool show_date;
-    int clock_mode; // 0 for local, 1 for UTC, 2 for Swatch
+    int clock_mode; // Mode_Id
     int win_x;      // Current window X position
     int win_y;      // Current window Y position
+    int win_w;      // Window size once shown
+    int win_h;
 
     /* Dragging state for window movement */
     Eina_Bool dragging;
@@ -71,50 +199,145 @@ typedef struct _App_Data {
     int drag_start_y;
     int win_start_x;
     int win_start_y;
+    int drag_win_w;           // Window size cached at drag start
+    int drag_win_h;
+    int drag_pointer_x;       // Latest pointer root position, applied once per frame
+    int drag_pointer_y;
+    Eina_Bool drag_pending;   // drag_pointer_* not yet applied to the window
+    Ecore_Animator *drag_animator;
+    unsigned long drag_events; // Motion events received this drag
+    unsigned long drag_moves;  // Window moves issued this drag
+    Eina_Bool wm_moving;       // The WM is moving the window for us
+    Ecore_Timer *wm_move_settle_timer;
 
     /* Click/Drag detection for Edje signals */
     Eina_Bool click_suppress; // New: Flag to suppress click actions if a drag occurred
     Evas_Coord mouse_down_x;  // New: X coordinate of mouse down
     Evas_Coord mouse_down_y;  // New: Y coordinate of mouse down
+
+    /* Visibility tracking - a hidden clock drops out of the shared tick */
+    Eina_Bool obscured;       // Fully covered by other windows
+    Eina_Bool iconified;      // Minimized
+    Eina_Bool suspended;      // Not rendered because of the above or a blanked screen
+
+    Eina_Bool batch_touched;  // Changed by the control batch being applied
+} Clock_Instance;
+
+/**
+ * @brief Application data structure
+ */
+typedef struct _App_Data {
+    /* Hosted clocks, all driven by one shared tick */
+    Eina_List *clocks;              // Clock_Instance list
+    char edj_path[PATH_MAX];        // Theme file shared by every clock
+    Ecore_Timer *timer;
+    int tick_fd;                    // CLOCK_REALTIME timerfd for aligned ticks, -1 if unavailable
+    Ecore_Fd_Handler *tick_handler;
+    Wheel wheel;                    // Every ticking clock's next deadline
+    struct timespec tick_deadline;  // Earliest of them, the one tick_fd is armed for
+    Tick_Stats tick_stats;
+    unsigned long render_updates;   // Render stats of clocks already closed
+    unsigned long render_skipped;
+
+    /* Configuration */
+    Config *config;
+    char *config_file;
+    Config_Store store;
+    Eina_Bool config_dirty;           // Live state differs from what is on disk
+    Eina_Bool config_closing;         // Shutting down, no new async writes
+    Ecore_Timer *config_flush_timer;  // Debounce timer for dirty config
+    Ecore_Thread *config_writer;      // In-flight background write
+    Config_Write_Job *config_job;     // Its job
+    unsigned long config_writes;      // Number of config.eet rewrites
+    Ecore_Ipc_Server *ipc_server;     // Accepts options from later launches
+    Control_Server *control;          // Local control socket
+    Timepage *timepage;               // Shared time page, NULL unless --publish-time
+    const Tz_Zone *local_zone;        // Local zone from its TZif file, NULL to use localtime_r()
+
+    /* Application state */
+    Eina_Bool debug;
+    Eina_Bool normal_window;
+    Eina_Bool show_seconds;
+    Eina_Bool wm_drag;        // Hand drags to the window manager/compositor
+    int snap_distance;        // Edge snapping distance while dragging, 0 to disable
+    int beats_precision; // Swatch fractional digits: 2 (@BBB.FF) or 0 (@BBB)
+    int clocks_min;           // --clocks: host at least this many clocks
+    Screen_Index screens;     // Output geometry, rebuilt on layout changes
+    Ecore_Timer *screens_change_timer;
+
+    /* Visibility tracking - ticks stop while nothing can be seen */
+    Eina_Bool blanked;        // Screensaver active
+    unsigned long suspends;   // Number of times a clock was suspended
+    Eina_List *handlers;      // Ecore_Event_Handler list
 } App_Data;
 
 /* Function prototypes */
 static Eina_Bool _timer_cb(void *data);
-static void _config_save(App_Data *ad);
-static Config *_config_load(App_Data *ad);
+static void _render_init(Clock_Instance *ci);
+static void _render_part_set(Clock_Instance *ci, Clock_Part part, const char *text);
+static const char *_date_text_get(Clock_Instance *ci, time_t rawtime, const struct tm *timeinfo);
+static void _config_save(Clock_Instance *ci);
+static void _config_dirty_set(App_Data *ad);
+static void _config_flush(App_Data *ad);
+static Eina_Bool _config_flush_timer_cb(void *data);
 static void _config_init(App_Data *ad);
 static void _config_shutdown(App_Data *ad);
-static Eet_Data_Descriptor *_config_descriptor_new(void);
 static void _date_click_cb(void *data, Evas_Object *obj, const char *emission, const char *source);
 static void _clock_mode_toggle_cb(void *data, Evas_Object *obj, const char *emission, const char *source);
 static void _utc_indicator_click_cb(void *data, Evas_Object *obj, const char *emission, const char *source);
 static void _mouse_down_cb(void *data, Evas *e, Evas_Object *obj, void *event_info);
 static void _mouse_up_cb(void *data, Evas *e, Evas_Object *obj, void *event_info);
 static void _mouse_move_cb(void *data, Evas *e, Evas_Object *obj, void *event_info);
+static Eina_Bool _wm_move_start(Clock_Instance *ci);
 static void _win_move_cb(void *data, Evas_Object *obj, void *event_info);
-static void _get_swatch_time(time_t rawtime, char *time_str, size_t time_str_len);
-static Eina_Bool _minute_timer_cb(void *data);
-static double _get_next_timer_interval(Eina_Bool show_seconds);
+static Eina_Bool _drag_pointer_move_cb(void *data, int type, void *event);
+static void _drag_end(Clock_Instance *ci);
+static void _clamp_window_position(Clock_Instance *ci, int win_w, int win_h, const Screen_Output *output);
+static void _clamp_bounds_get(App_Data *ad, const Screen_Output *output, int win_w, int win_h, Drag_Bounds *b);
+static void _clamp_window_to_output(Clock_Instance *ci);
+static const Screen_Output *_window_output_get(Clock_Instance *ci);
+static Eina_Bool _tick_timer_cb(void *data);
+static double _get_next_timer_interval(const struct timespec *deadline);
+static void _tick_init(App_Data *ad);
+static void _tick_shutdown(App_Data *ad);
+static void _tick_schedule(App_Data *ad);
+static void _tick_arm(App_Data *ad);
+static void _tick_fire(App_Data *ad);
+static void _clock_tick_cb(void *data, int64_t now);
+static void _clock_schedule(App_Data *ad);
+static void _clock_jump_handle(App_Data *ad);
+static void _clock_unschedule(App_Data *ad);
+static Clock_Instance *_clock_add(App_Data *ad, Config_Clock *cc);
+static void _clock_del(Clock_Instance *ci);
+static void _clock_close(Clock_Instance *ci);
+static Clock_Instance *_clock_find_by_xwin(App_Data *ad, Ecore_X_Window xwin);
+static void _visibility_init(App_Data *ad);
+static void _handlers_shutdown(App_Data *ad);
+static Eina_Bool _screens_rebuild(App_Data *ad);
+static void _options_parse(Options *o, int argc, char **argv);
+static void _options_apply(App_Data *ad, const Options *o);
+static void _options_clocks_apply(App_Data *ad, const Options *o);
+static void _clock_position_restore(Clock_Instance *ci);
+static void _clock_formats_compile(Clock_Instance *ci);
+static void _tick_deadline_next(Clock_Instance *ci, const struct timespec *now, struct timespec *deadline);
 
 
 /**
- * @brief Creates EET data descriptor for configuration
+ * @brief Builds the configuration directory path, creating the directory if needed
  */
-static Eet_Data_Descriptor *
-_config_descriptor_new(void)
+static void
+_config_dir_get(char *config_dir, size_t len)
 {
-    Eet_Data_Descriptor_Class eddc;
-    Eet_Data_Descriptor *edd;
+    const char *home;
 
-    EET_EINA_STREAM_DATA_DESCRIPTOR_CLASS_SET(&eddc, Config);
-    edd = eet_data_descriptor_stream_new(&eddc);
+    home = getenv("HOME");
+    if (!home) home = "/tmp";
 
-    EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Config, "show_date", show_date, EET_T_UCHAR);
-    EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Config, "clock_mode", clock_mode, EET_T_INT);
-    EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Config, "win_x", win_x, EET_T_INT);
-    EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Config, "win_y", win_y, EET_T_INT);
+    snprintf(config_dir, len, "%s/.config/elive-clock", home);
 
-    return edd;
+    if (mkdir(config_dir, 0755) < 0 && errno != EEXIST) {
+        fprintf(stderr, "Warning: Failed to create config directory: %s\n", strerror(errno));
+    }
 }
 
 /**
@@ -124,115 +347,248 @@ static void
 _config_init(App_Data *ad)
 {
     char config_dir[PATH_MAX];
-    const char *home;
-
-    home = getenv("HOME");
-    if (!home) home = "/tmp";
 
     // Ensure enough space for the suffix in the full path
-    snprintf(config_dir, sizeof(config_dir) - CONFIG_FILE_SUFFIX_LEN, "%s/.config/elive-clock", home);
-
-    if (mkdir(config_dir, 0755) < 0 && errno != EEXIST) {
-        fprintf(stderr, "Warning: Failed to create config directory: %s\n", strerror(errno));
-    }
+    _config_dir_get(config_dir, sizeof(config_dir) - CONFIG_FILE_SUFFIX_LEN);
 
     ad->config_file = malloc(PATH_MAX);
     // Concatenate the directory and the config file name
     snprintf(ad->config_file, PATH_MAX, "%s%s", config_dir, CONFIG_FILE_SUFFIX);
 
-    ad->config = _config_load(ad);
+    config_store_init(&ad->store);
+    config_store_map(&ad->store, ad->config_file);
+
+    ad->config = config_store_load(&ad->store);
     if (!ad->config) {
         // If no config file exists or loading failed, create a new one with defaults
         ad->config = calloc(1, sizeof(Config));
-        ad->config->show_date = EINA_TRUE;
-        ad->config->clock_mode = CLOCK_MODE_LOCAL; // Default to local time
-        ad->config->win_x = 0; // Default position for new configs
-        ad->config->win_y = 0;
-        _config_save(ad); // Save the new default config
+        config_clock_new(ad->config);
+        _config_dirty_set(ad); // Save the new default config
     }
 
-    // Load current settings from config into app data
-    ad->show_date = ad->config->show_date;
-    ad->clock_mode = ad->config->clock_mode;
-    ad->win_x = ad->config->win_x;
-    ad->win_y = ad->config->win_y;
+    // Host as many clocks as requested on the command line
+    while ((int)eina_list_count(ad->config->clocks) < ad->clocks_min) {
+        if (!config_clock_new(ad->config)) break;
+        _config_dirty_set(ad);
+    }
 }
 
 /**
  * @brief Shuts down the configuration system
+ *
+ * Waits for an in-flight background write, then writes any remaining
+ * dirty state synchronously. A write that does not finish in time is
+ * abandoned: it keeps its tmp file and descriptors, and the remaining
+ * state is not written.
  */
 static void
 _config_shutdown(App_Data *ad)
 {
+    Clock_Instance *ci;
+    Eina_List *l;
+    Eina_Bool abandoned = EINA_FALSE;
+
+    ad->config_closing = EINA_TRUE;
+
+    if (ad->config_flush_timer) {
+        ecore_timer_del(ad->config_flush_timer);
+        ad->config_flush_timer = NULL;
+    }
+
+    if (ad->config_writer && !ecore_thread_wait(ad->config_writer, CONFIG_SHUTDOWN_WAIT)) {
+        fprintf(stderr, "Warning: Configuration write still in progress, latest changes not saved\n");
+        ecore_thread_cancel(ad->config_writer);
+        ad->config_job->ad = NULL;
+        abandoned = EINA_TRUE;
+    }
+    ad->config_writer = NULL;
+    ad->config_job = NULL;
+
     if (ad->config) {
-        _config_save(ad);
+        EINA_LIST_FOREACH(ad->clocks, l, ci)
+            _config_save(ci);
+        if (!abandoned && ad->config_dirty && !config_store_unchanged(&ad->store, ad->config) &&
+            config_write(ad->config_file, ad->store.edd, ad->config)) {
+            ad->config_dirty = EINA_FALSE;
+            ad->config_writes++;
+        }
+        if (ad->debug) fprintf(stderr, "DEBUG: Configuration written %lu times\n", ad->config_writes);
+        EINA_LIST_FOREACH(ad->clocks, l, ci)
+            ci->config = NULL;
+        config_clear(ad->config);
         free(ad->config);
         ad->config = NULL;
     }
 
+    config_store_close(&ad->store);
+
     if (ad->config_file) {
         free(ad->config_file);
         ad->config_file = NULL;
     }
+
+    // Still in use by the abandoned write
+    if (!abandoned) config_store_descriptors_free(&ad->store);
 }
 
 /**
- * @brief Loads configuration from file
+ * @brief Config writer thread - performs the blocking write
  */
-static Config *
-_config_load(App_Data *ad)
+static void
+_config_writer_run_cb(void *data, Ecore_Thread *thread EINA_UNUSED)
 {
-    Eet_File *ef;
-    Config *config = NULL;
-    Eet_Data_Descriptor *edd;
+    Config_Write_Job *job = data;
+
+    job->ok = config_write(job->path, job->edd, &job->config);
+}
+
+/**
+ * @brief Config writer completion - back on the main loop
+ */
+static void
+_config_writer_end_cb(void *data, Ecore_Thread *thread EINA_UNUSED)
+{
+    Config_Write_Job *job = data;
+    App_Data *ad = job->ad;
+
+    if (!ad) {
+        config_clear(&job->config);
+        free(job);
+        return;
+    }
+
+    ad->config_writer = NULL;
+    ad->config_job = NULL;
+    if (job->ok) {
+        ad->config_writes++;
+        config_store_written_set(&ad->store, &job->config);
+        if (!ad->config_closing) config_store_map(&ad->store, ad->config_file);
+    } else {
+        fprintf(stderr, "Warning: Could not save configuration\n");
+        ad->config_dirty = EINA_TRUE;
+    }
+    config_clear(&job->config);
+    free(job);
+
+    // State changed while we were writing; write again
+    if (ad->config_dirty && !ad->config_closing) _config_flush(ad);
+}
 
-    ef = eet_open(ad->config_file, EET_FILE_MODE_READ);
-    if (!ef) return NULL;
+/**
+ * @brief Debounce timer - the config has been quiet long enough
+ */
+static Eina_Bool
+_config_flush_timer_cb(void *data)
+{
+    App_Data *ad = data;
 
-    edd = _config_descriptor_new();
-    config = eet_data_read(ef, edd, "config");
-    eet_data_descriptor_free(edd);
-    eet_close(ef);
+    ad->config_flush_timer = NULL;
+    _config_flush(ad);
 
-    return config;
+    return ECORE_CALLBACK_CANCEL;
 }
 
 /**
- * @brief Saves configuration to file
+ * @brief Starts writing dirty configuration on a background thread
  */
 static void
-_config_save(App_Data *ad)
+_config_flush(App_Data *ad)
 {
-    Eet_File *ef;
-    Eet_Data_Descriptor *edd;
+    Config_Write_Job *job;
 
-    if (!ad->config) return;
+    if (ad->config_flush_timer) {
+        ecore_timer_del(ad->config_flush_timer);
+        ad->config_flush_timer = NULL;
+    }
 
-    ad->config->show_date = ad->show_date;
-    ad->config->clock_mode = ad->clock_mode;
-    ad->config->win_x = ad->win_x;
-    ad->config->win_y = ad->win_y;
+    // A write in flight picks up the remaining dirty state when it ends
+    if (!ad->config || !ad->config_dirty || ad->config_writer || ad->config_closing) return;
 
-    ef = eet_open(ad->config_file, EET_FILE_MODE_WRITE);
-    if (!ef) {
-        fprintf(stderr, "Warning: Could not save configuration\n");
+    // Changed and changed back since the last write: nothing to do
+    if (config_store_unchanged(&ad->store, ad->config)) {
+        ad->config_dirty = EINA_FALSE;
         return;
     }
 
-    edd = _config_descriptor_new();
-    eet_data_write(ef, edd, "config", ad->config, EINA_TRUE);
-    eet_data_descriptor_free(edd);
-    eet_close(ef);
+    job = calloc(1, sizeof(Config_Write_Job));
+    if (!job) return;
+    job->ad = ad;
+    job->edd = ad->store.edd;
+    snprintf(job->path, sizeof(job->path), "%s", ad->config_file);
+    config_copy(&job->config, ad->config);
+
+    ad->config_dirty = EINA_FALSE;
+    ad->config_writer = ecore_thread_run(_config_writer_run_cb, _config_writer_end_cb,
+                                         _config_writer_end_cb, job);
+    if (ad->config_writer) ad->config_job = job;
+}
+
+/**
+ * @brief Marks the configuration dirty and (re)starts the debounce timer
+ *
+ * Writes are coalesced: they happen after CONFIG_FLUSH_DELAY seconds
+ * without further changes, at the end of a drag, or on shutdown.
+ */
+static void
+_config_dirty_set(App_Data *ad)
+{
+    Config_Clock *first = eina_list_data_get(ad->config->clocks);
+
+    // Keep the single-clock fields in step for older versions
+    if (first) config_clock_copy(&ad->config->legacy, first);
+
+    ad->config_dirty = EINA_TRUE;
+
+    if (ad->config_closing) return;
+
+    if (ad->config_flush_timer) {
+        ecore_timer_reset(ad->config_flush_timer);
+    } else {
+        ad->config_flush_timer = ecore_timer_add(CONFIG_FLUSH_DELAY, _config_flush_timer_cb, ad);
+    }
+}
+
+/**
+ * @brief Saves configuration - records a clock's live state and schedules a write
+ */
+static void
+_config_save(Clock_Instance *ci)
+{
+    App_Data *ad = ci->ad;
+    Config_Clock *c = ci->config;
+    const Screen_Output *o;
+    Eina_Bool changed;
+
+    if (!ad->config || !c) return;
+
+    changed = c->show_date != ci->show_date || c->clock_mode != ci->clock_mode ||
+              c->win_x != ci->win_x || c->win_y != ci->win_y;
+
+    c->show_date = ci->show_date;
+    c->clock_mode = ci->clock_mode;
+    c->win_x = ci->win_x;
+    c->win_y = ci->win_y;
+
+    // Remember the position relative to its output, so it survives layout changes
+    if (ad->screens.count && (o = _window_output_get(ci))) {
+        if (eina_stringshare_replace(&c->output, o->name)) changed = EINA_TRUE;
+        if (c->output_x != ci->win_x - o->x || c->output_y != ci->win_y - o->y) changed = EINA_TRUE;
+        c->output_x = ci->win_x - o->x;
+        c->output_y = ci->win_y - o->y;
+    }
+
+    if (!changed) return;
+    _config_dirty_set(ad);
 }
 
 /**
  * @brief Close button callback
  */
 static void
-_close_cb(void *data EINA_UNUSED, Evas_Object *obj EINA_UNUSED,
+_close_cb(void *data, Evas_Object *obj EINA_UNUSED,
           const char *emission EINA_UNUSED, const char *source EINA_UNUSED)
 {
-    ecore_main_loop_quit();
+    _clock_close(data);
 }
 
 /**
@@ -242,14 +598,14 @@ static void
 _date_click_cb(void *data, Evas_Object *obj EINA_UNUSED,
                const char *emission EINA_UNUSED, const char *source EINA_UNUSED)
 {
-    App_Data *ad = data;
-    if (ad->click_suppress) return; // Suppress if a drag was detected
+    Clock_Instance *ci = data;
+    if (ci->click_suppress) return; // Suppress if a drag was detected
 
-    ad->show_date = !ad->show_date;
+    ci->show_date = !ci->show_date;
 
-    elm_layout_signal_emit(obj, ad->show_date ? "date,show" : "date,hide", "elm");
-    _config_save(ad);
-    _timer_cb(ad);
+    elm_layout_signal_emit(obj, ci->show_date ? "date,show" : "date,hide", "elm");
+    _timer_cb(ci);
+    _config_save(ci);
 }
 
 /**
@@ -259,386 +615,1915 @@ static void
 _utc_indicator_click_cb(void *data, Evas_Object *obj EINA_UNUSED,
                const char *emission EINA_UNUSED, const char *source EINA_UNUSED)
 {
-    App_Data *ad = data;
-    if (ad->click_suppress) return; // Suppress if a drag was detected
+    Clock_Instance *ci = data;
+    const Mode *mode = mode_get(ci->clock_mode);
+    if (ci->click_suppress) return; // Suppress if a drag was detected
 
-    // If the current mode is Swatch Internet Time, launch web-launcher
-    if (ad->clock_mode == CLOCK_MODE_SWATCH)
-    {
-        ecore_exe_run("web-launcher https://internettime.elivecd.org/", NULL);
+    // Modes with a web page (Swatch Internet Time) open it in web-launcher
+    if (mode->link) {
+        char cmd[PATH_MAX];
+
+        snprintf(cmd, sizeof(cmd), "web-launcher %s", mode->link);
+        ecore_exe_run(cmd, NULL);
     }
 
-    _timer_cb(ad);
+    _timer_cb(ci);
 }
 
 /**
- * @brief Callback for toggling clock display mode (Local, UTC, Swatch)
+ * @brief Callback for cycling the clock display mode through the registered modes
  */
 static void
 _clock_mode_toggle_cb(void *data, Evas_Object *obj EINA_UNUSED,
                       const char *emission EINA_UNUSED, const char *source EINA_UNUSED)
 {
-    App_Data *ad = data;
-    if (ad->click_suppress) return; // Suppress if a drag was detected
-
-    ad->clock_mode++;
-    if (ad->clock_mode > CLOCK_MODE_SWATCH) {
-        ad->clock_mode = CLOCK_MODE_LOCAL;
-    }
-    _config_save(ad);
-
-    // Delete existing timer
-    if (ad->timer) {
-        ecore_timer_del(ad->timer);
-        ad->timer = NULL;
-    }
+    Clock_Instance *ci = data;
+    if (ci->click_suppress) return; // Suppress if a drag was detected
 
-    // Set up new timer based on the selected mode and original show_seconds preference
-    if (ad->clock_mode == CLOCK_MODE_SWATCH) {
-        ad->timer = ecore_timer_add(TIMER_INTERVAL_SECONDS, _timer_cb, ad);
-    } else { // CLOCK_MODE_LOCAL or CLOCK_MODE_UTC
-        if (ad->show_seconds) {
-            ad->timer = ecore_timer_add(TIMER_INTERVAL_SECONDS, _timer_cb, ad);
-        } else {
-            // Use _minute_timer_cb to align to the next minute, then switch to regular minute updates
-            double interval = _get_next_timer_interval(EINA_FALSE);
-            ad->timer = ecore_timer_add(interval, _minute_timer_cb, ad);
-        }
-    }
+    ci->clock_mode = mode_next(ci->clock_mode);
+    _clock_schedule(ci->ad);
 
-    _timer_cb(ad); // Immediately update the display
+    _timer_cb(ci); // Immediately update the display
+    _config_save(ci);
 }
 
 /**
- * @brief Calculates Swatch Internet Time (@beats)
- * @param rawtime The current time in UTC.
- * @param time_str Buffer to store the formatted time string.
- * @param time_str_len Length of the time_str buffer.
+ * @brief Initializes the render stage and caches the Edje handle
  */
 static void
-_get_swatch_time(time_t rawtime, char *time_str, size_t time_str_len)
+_render_init(Clock_Instance *ci)
 {
-    struct tm timeinfo_utc;
-    struct tm *timeinfo;
-    double beats;
-
-    // Get UTC time
-    timeinfo = gmtime_r(&rawtime, &timeinfo_utc);
+    memset(&ci->render, 0, sizeof(ci->render));
+    ci->render.edje = elm_layout_edje_get(ci->layout);
+}
 
-    // Swatch Internet Time (Biel Mean Time - BMT) is UTC+1
-    // Calculate seconds since midnight BMT
-    int hour_bmt = timeinfo->tm_hour + 1; // UTC+1
-    int min_bmt = timeinfo->tm_min;
-    int sec_bmt = timeinfo->tm_sec;
+/**
+ * @brief Pushes text to an Edje part only if it differs from the last push
+ */
+static void
+_render_part_set(Clock_Instance *ci, Clock_Part part, const char *text)
+{
+    Render_Cache *rc = &ci->render;
 
-    // Handle day wrap-around for BMT (e.g., 23:00 UTC becomes 00:00 BMT next day)
-    if (hour_bmt >= 24) {
-        hour_bmt -= 24;
+    if (rc->valid[part] && !strcmp(rc->text[part], text)) {
+        rc->skipped++;
+        return;
     }
 
-    long total_seconds_bmt = (long)hour_bmt * 3600 + (long)min_bmt * 60 + (long)sec_bmt;
-
-    // 1 day = 1000 beats. 1 beat = 86.4 seconds.
-    beats = (double)total_seconds_bmt / 86.4;
+    snprintf(rc->text[part], sizeof(rc->text[part]), "%s", text);
+    rc->valid[part] = EINA_TRUE;
+    rc->updates++;
 
-    snprintf(time_str, time_str_len, "@%06.2f", beats); // Format as @BBB.FF
+    edje_object_part_text_set(rc->edje, _clock_part_names[part], text);
 }
 
 /**
- * @brief Timer callback - updates time and date display
+ * @brief Returns the date string, reformatting it only when the cached one is stale
+ * @param rawtime The current time.
+ * @param timeinfo Broken-down @p rawtime in the zone the date is shown in.
+ *
+ * The cached date is valid until the next midnight of the zone it was
+ * computed in, or less if the date format shows the time of day. A
+ * change of UTC offset (DST transition or a new timezone), of clock
+ * mode, or a step of the clock out of that day invalidates it
+ * immediately.
  */
-static Eina_Bool
-_timer_cb(void *data)
+static const char *
+_date_text_get(Clock_Instance *ci, time_t rawtime, const struct tm *timeinfo)
 {
-    App_Data *ad = data;
-    time_t rawtime;
-    struct tm timeinfo_buf; // Buffer for reentrant time functions
-    struct tm *timeinfo;
-    char time_str[32];
-    char date_str[64];
-
-    time(&rawtime);
-
-    switch (ad->clock_mode) {
-        case CLOCK_MODE_LOCAL:
-            timeinfo = localtime_r(&rawtime, &timeinfo_buf); // Use local time
-            strftime(time_str, sizeof(time_str),
-                     ad->show_seconds ? "%H:%M:%S" : "%H:%M", timeinfo);
-            strftime(date_str, sizeof(date_str), "%A, %B %d, %Y", timeinfo);
-            edje_object_part_text_set(elm_layout_edje_get(ad->layout), "utc_indicator_text", "");
-            break;
-        case CLOCK_MODE_UTC:
-            timeinfo = gmtime_r(&rawtime, &timeinfo_buf); // Use UTC time
-            strftime(time_str, sizeof(time_str),
-                     ad->show_seconds ? "%H:%M:%S" : "%H:%M", timeinfo);
-            strftime(date_str, sizeof(date_str), "%A, %B %d, %Y", timeinfo);
-            edje_object_part_text_set(elm_layout_edje_get(ad->layout), "utc_indicator_text", "UTC");
-            break;
-        case CLOCK_MODE_SWATCH:
-            _get_swatch_time(rawtime, time_str, sizeof(time_str));
-            strftime(date_str, sizeof(date_str), "%A, %B %d, %Y", localtime_r(&rawtime, &timeinfo_buf)); // Display local date for Swatch
-            edje_object_part_text_set(elm_layout_edje_get(ad->layout), "utc_indicator_text", "Internet Time");
-            break;
-        default:
-            // Should not happen, fall back to local
-            timeinfo = localtime_r(&rawtime, &timeinfo_buf);
-            strftime(time_str, sizeof(time_str),
-                     ad->show_seconds ? "%H:%M:%S" : "%H:%M", timeinfo);
-            strftime(date_str, sizeof(date_str), "%A, %B %d, %Y", timeinfo);
-            edje_object_part_text_set(elm_layout_edje_get(ad->layout), "utc_indicator_text", "");
-            break;
+    Date_Cache *dc = &ci->date;
+
+    if (dc->valid && dc->clock_mode == ci->clock_mode &&
+        dc->gmtoff == timeinfo->tm_gmtoff &&
+        rawtime >= dc->valid_from && rawtime < dc->valid_until) {
+        return dc->text;
     }
 
-    edje_object_part_text_set(elm_layout_edje_get(ad->layout), "time_text", time_str);
-    edje_object_part_text_set(elm_layout_edje_get(ad->layout), "date_text", date_str);
+    format_exec(&ci->date_format, timeinfo, dc->text, sizeof(dc->text));
 
-    return ECORE_CALLBACK_RENEW;
-}
+    // Lower bound catches the clock being stepped backwards over midnight
+    dc->valid_from = rawtime - (timeinfo->tm_hour * 3600 + timeinfo->tm_min * 60 + timeinfo->tm_sec);
 
-/**
- * @brief Calculates interval until next minute
- */
-static double
-_get_next_timer_interval(Eina_Bool show_seconds)
-{
-    if (show_seconds) return TIMER_INTERVAL_SECONDS;
+    if (mode_get(ci->clock_mode)->date_utc) {
+        dc->valid_until = rawtime - (rawtime % 86400) + 86400;
+    } else if (ci->ad->local_zone) {
+        Tz_Info info;
+
+        // Next local midnight, unless the UTC offset changes first
+        tz_lookup(ci->ad->local_zone, rawtime, &info);
+        dc->valid_until = dc->valid_from + 86400;
+        if (info.next < dc->valid_until) dc->valid_until = info.next;
+    } else {
+        struct tm next = *timeinfo;
+
+        next.tm_mday++;
+        next.tm_hour = 0;
+        next.tm_min = 0;
+        next.tm_sec = 0;
+        next.tm_isdst = -1;
+        dc->valid_until = mktime(&next);
+        if (dc->valid_until <= rawtime) dc->valid_until = rawtime + 1;
+    }
+
+    // A date format showing the time of day goes stale sooner
+    if (ci->date_format.resolution < FORMAT_RES_DAY) {
+        time_t res = ci->date_format.resolution;
 
-    time_t rawtime;
-    struct tm *timeinfo;
+        dc->valid_from = rawtime - rawtime % res;
+        if (dc->valid_until > dc->valid_from + res) dc->valid_until = dc->valid_from + res;
+    }
+
+    dc->clock_mode = ci->clock_mode;
+    dc->gmtoff = timeinfo->tm_gmtoff;
+    dc->valid = EINA_TRUE;
+    dc->recomputes++;
 
-    time(&rawtime);
-    timeinfo = localtime(&rawtime);
+    if (ci->ad->debug) {
+        fprintf(stderr, "DEBUG: Date recomputed: '%s', valid for %ld s\n",
+                dc->text, (long)(dc->valid_until - rawtime));
+    }
 
-    return (double)(60 - timeinfo->tm_sec);
+    return dc->text;
 }
 
 /**
- * @brief Window delete callback
+ * @brief Fills in what the clock's mode needs to render and schedule it
  */
 static void
-_win_del_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+_mode_ctx_get(const Clock_Instance *ci, Mode_Ctx *ctx)
 {
-    App_Data *ad = data;
-
-    if (ad->timer) ecore_timer_del(ad->timer);
-    _config_shutdown(ad);
-    ecore_main_loop_quit();
+    ctx->zone = ci->ad->local_zone;
+    ctx->time_format = &ci->time_format;
+    ctx->beats_precision = ci->ad->beats_precision;
 }
 
 /**
- * @brief Mouse down callback - starts dragging or prepares for click detection
+ * @brief Whether @p ci is the clock mirrored into the time page
  */
-static void
-_mouse_down_cb(void *data, Evas *e EINA_UNUSED,
-               Evas_Object *obj EINA_UNUSED, void *event_info)
+static Eina_Bool
+_clock_published(const Clock_Instance *ci)
 {
-    App_Data *ad = data;
-    Evas_Event_Mouse_Down *ev = event_info;
-
-    if (ev->button != 1) return;
-
-    // Record initial mouse position for click/drag detection
-    ad->mouse_down_x = ev->canvas.x;
-    ad->mouse_down_y = ev->canvas.y;
-    ad->click_suppress = EINA_FALSE; // Reset suppression flag for new click/drag
-    ad->dragging = EINA_FALSE; // Not dragging yet
-
-    // Save window position for potential drag
-    evas_object_geometry_get(ad->win, &ad->win_start_x, &ad->win_start_y, NULL, NULL);
-
-    // Save pointer position for potential drag
-    Ecore_X_Window xwin = elm_win_xwindow_get(ad->win);
-    if (!xwin) return;
-    Ecore_X_Window root = ecore_x_window_root_get(xwin);
-    ecore_x_pointer_xy_get(root, &ad->drag_start_x, &ad->drag_start_y);
-    // Do not grab pointer yet; only grab if drag threshold is exceeded
+    return ci->ad->timepage && ci == eina_list_data_get(ci->ad->clocks);
 }
 
 /**
- * @brief Mouse up callback - ends dragging and allows click if no drag occurred
+ * @brief Whether @p ci needs ticks - when visible, or when it feeds the time page
  */
-static void
-_mouse_up_cb(void *data, Evas *e EINA_UNUSED,
-             Evas_Object *obj EINA_UNUSED, void *event_info)
+static Eina_Bool
+_clock_ticking(const Clock_Instance *ci)
 {
-    App_Data *ad = data;
-    Evas_Event_Mouse_Up *ev = event_info;
-
-    if (ev->button != 1) return;
-
-    if (ad->dragging) {
-        ecore_x_pointer_ungrab();
-        ad->dragging = EINA_FALSE;
-        // click_suppress remains set, so click is not allowed after drag
-    } else {
-        // If not dragging, allow click (click_suppress should be false)
-        ad->click_suppress = EINA_FALSE;
-    }
-    // click_suppress will be reset on next mouse down
+    return !ci->suspended || _clock_published(ci);
 }
 
 /**
- * @brief Mouse move callback - handles dragging and updates click suppression
+ * @brief Mirrors what a clock shows into the time page
  */
 static void
-_mouse_move_cb(void *data, Evas *e EINA_UNUSED,
-               Evas_Object *obj EINA_UNUSED, void *event_info)
+_timepage_update(Clock_Instance *ci, const struct timespec *now,
+                 const char *time_str, const char *date_str, const char *indicator)
 {
-    App_Data *ad = data;
-    Evas_Event_Mouse_Move *ev = event_info;
-
-    if (ev->buttons != 1) return; // Only handle left button moves
-
-    // Calculate drag distance from initial mouse down
-    int dx = ev->cur.canvas.x - ad->mouse_down_x;
-    int dy = ev->cur.canvas.y - ad->mouse_down_y;
-    int dist_sq = dx * dx + dy * dy;
-    const int drag_threshold = 5; // pixels
-    const int drag_threshold_sq = drag_threshold * drag_threshold;
-
-    if (!ad->dragging) {
-        // Only start dragging if moved more than threshold
-        if (dist_sq > drag_threshold_sq) {
-            ad->dragging = EINA_TRUE;
-            ad->click_suppress = EINA_TRUE; // Suppress click if dragging
-            // Grab pointer now
-            Ecore_X_Window xwin = elm_win_xwindow_get(ad->win);
-            if (xwin) ecore_x_pointer_grab(xwin);
-        } else {
-            // Not enough movement, do not drag, do not suppress click
-            return;
-        }
-    }
-
-    // If dragging, move the window
-    Ecore_X_Window xwin = elm_win_xwindow_get(ad->win);
-    if (!xwin) return;
+    Timepage_Data d;
+    struct timespec deadline;
+
+    _tick_deadline_next(ci, now, &deadline);
+
+    memset(&d, 0, sizeof(d));
+    d.updated_sec = now->tv_sec;
+    d.updated_nsec = now->tv_nsec;
+    d.deadline_sec = deadline.tv_sec;
+    d.deadline_nsec = deadline.tv_nsec;
+    d.clock_mode = ci->clock_mode;
+    d.show_date = ci->show_date;
+    snprintf(d.mode, sizeof(d.mode), "%s", mode_get(ci->clock_mode)->name);
+    snprintf(d.indicator, sizeof(d.indicator), "%s", indicator);
+    snprintf(d.time, sizeof(d.time), "%s", time_str);
+    snprintf(d.date, sizeof(d.date), "%s", date_str);
+
+    timepage_publish(ci->ad->timepage, &d);
+}
 
-    int x_pointer, y_pointer;
-    Ecore_X_Window root = ecore_x_window_root_get(xwin);
-    ecore_x_pointer_xy_get(root, &x_pointer, &y_pointer);
+/**
+ * @brief Timer callback - updates one clock's time and date display
+ *
+ * A suspended clock is only computed, for the time page, not rendered.
+ */
+static Eina_Bool
+_timer_cb(void *data)
+{
+    Clock_Instance *ci = data;
+    const Mode *mode = mode_get(ci->clock_mode);
+    Mode_Ctx ctx;
+    struct timespec now;
+    struct tm timeinfo; // Broken down in the zone the date is shown in
+    char time_str[RENDER_TEXT_MAX];
+    const char *indicator, *date_str;
 
-    int new_x = ad->win_start_x + (x_pointer - ad->drag_start_x);
-    int new_y = ad->win_start_y + (y_pointer - ad->drag_start_y);
+    clock_gettime(CLOCK_REALTIME, &now);
 
-    // Clamp to allow dragging window up to 30% outside the screen
-    int screen_x, screen_y, screen_w, screen_h;
-    elm_win_screen_size_get(ad->win, &screen_x, &screen_y, &screen_w, &screen_h);
+    _mode_ctx_get(ci, &ctx);
+    mode->render(&ctx, &now, &timeinfo, time_str, sizeof(time_str));
+    indicator = mode->indicator;
 
-    int win_w, win_h;
-    evas_object_geometry_get(ad->win, NULL, NULL, &win_w, &win_h);
+    date_str = _date_text_get(ci, now.tv_sec, &timeinfo);
+    if (_clock_published(ci)) _timepage_update(ci, &now, time_str, date_str, indicator);
 
-    int min_x = screen_x - (int)(win_w * 0.3);
-    int max_x = screen_x + screen_w - (int)(win_w * 0.7);
-    if (new_x < min_x) new_x = min_x;
-    if (new_x > max_x) new_x = max_x;
+    // Kept ticking only for the time page
+    if (ci->suspended) return ECORE_CALLBACK_RENEW;
 
-    int min_y = screen_y - (int)(win_h * 0.3);
-    int max_y = screen_y + screen_h - (int)(win_h * 0.7);
-    if (new_y < min_y) new_y = min_y;
-    if (new_y > max_y) new_y = max_y;
+    _render_part_set(ci, CLOCK_PART_INDICATOR, indicator);
+    _render_part_set(ci, CLOCK_PART_TIME, time_str);
+    _render_part_set(ci, CLOCK_PART_DATE, date_str);
 
-    ecore_x_window_move(xwin, new_x, new_y);
-    evas_object_move(ad->win, new_x, new_y);
+    return ECORE_CALLBACK_RENEW;
 }
 
 /**
- * @brief Callback for window move events to save position
+ * @brief Converts a timespec to nanoseconds, as kept by the timing wheel
  */
-static void
-_win_move_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+static int64_t
+_timespec_ns(const struct timespec *ts)
 {
-    App_Data *ad = data;
-    evas_object_geometry_get(ad->win, &ad->win_x, &ad->win_y, NULL, NULL);
-    _config_save(ad);
+    return (int64_t)ts->tv_sec * 1000000000LL + ts->tv_nsec;
 }
 
 /**
- * @brief Prints help message
+ * @brief Converts nanoseconds back to a timespec
  */
 static void
-_print_help(const char *prog_name)
+_timespec_from_ns(int64_t ns, struct timespec *ts)
 {
-    printf("Elive Clock v1.0 - A beautiful desktop clock\n\n");
-    printf("Usage: %s [OPTIONS]\n\n", prog_name);
-    printf("Options:\n");
-    printf("  --debug    Enable debug output\n");
-    printf("  --normal   Create a normal window (not a desktop gadget)\n");
-    printf("  --seconds  Show seconds in the time display\n");
-    printf("  --help     Show this help message\n\n");
+    ts->tv_sec = ns / 1000000000LL;
+    ts->tv_nsec = ns % 1000000000LL;
 }
 
 /**
- * @brief One-shot timer for minute synchronization
+ * @brief Calculates the relative interval until an absolute deadline
  */
-static Eina_Bool
-_minute_timer_cb(void *data)
+static double
+_get_next_timer_interval(const struct timespec *deadline)
 {
-    App_Data *ad = data;
+    struct timespec now;
 
-    _timer_cb(ad);
+    clock_gettime(CLOCK_REALTIME, &now);
 
-    if (ad->timer) ecore_timer_del(ad->timer);
-    ad->timer = ecore_timer_add(TIMER_INTERVAL_MINUTES, _timer_cb, ad);
-
-    return ECORE_CALLBACK_CANCEL;
+    return (double)(deadline->tv_sec - now.tv_sec) +
+           (double)(deadline->tv_nsec - now.tv_nsec) / 1e9 + TICK_FALLBACK_SLACK;
 }
 
 /**
- * @brief Clamp window position to fit within screen limits and allowed clamping
+ * @brief Records how late the current tick landed after its boundary
  */
 static void
-_clamp_window_position(App_Data *ad, int win_w, int win_h, int screen_x, int screen_y, int screen_w, int screen_h)
+_tick_lateness_record(App_Data *ad)
 {
-    int x = ad->win_x;
-    int y = ad->win_y;
-    Eina_Bool position_adjusted = EINA_FALSE;
+    Tick_Stats *ts = &ad->tick_stats;
+    struct timespec now;
+    long long late_ns;
 
-    // Allow window to be up to 30% outside the screen horizontally
-    int min_x = screen_x - (int)(win_w * 0.3);
-    int max_x = screen_x + screen_w - (int)(win_w * 0.7);
-    if (x < min_x) {
-        if (ad->debug) fprintf(stderr, "DEBUG: Adjusting window X from %d to %d (left 30%% clamp)\n", x, min_x);
-        x = min_x;
-        position_adjusted = EINA_TRUE;
+    clock_gettime(CLOCK_REALTIME, &now);
+    late_ns = (long long)(now.tv_sec - ad->tick_deadline.tv_sec) * 1000000000LL +
+              (now.tv_nsec - ad->tick_deadline.tv_nsec);
+
+    ts->ticks++;
+    ts->last_late_ns = late_ns;
+    ts->total_late_ns += late_ns;
+    if (late_ns > ts->max_late_ns) ts->max_late_ns = late_ns;
+
+    if (ad->debug) {
+        fprintf(stderr, "DEBUG: Tick landed %.3f ms after the boundary\n", late_ns / 1e6);
     }
-    if (x > max_x) {
-        if (ad->debug) fprintf(stderr, "DEBUG: Adjusting window X from %d to %d (right 30%% clamp)\n", x, max_x);
-        x = max_x;
+}
+
+/**
+ * @brief Handles a discontinuity of the realtime clock
+ *
+ * Everything derived from the old wall-clock time is stale: drop the
+ * cached dates, re-render right away and re-arm against the new time.
+ */
+static void
+_clock_jump_handle(App_Data *ad)
+{
+    Clock_Instance *ci;
+    Eina_List *l;
+
+    ad->tick_stats.clock_jumps++;
+    if (ad->debug) fprintf(stderr, "DEBUG: Realtime clock was set, re-rendering and rescheduling\n");
+
+    EINA_LIST_FOREACH(ad->clocks, l, ci) {
+        ci->date.valid = EINA_FALSE;
+        if (_clock_ticking(ci)) _timer_cb(ci);
+    }
+    _clock_schedule(ad);
+}
+
+/**
+ * @brief Queues a clock's next tick in the wheel, or drops it when it needs none
+ */
+static void
+_clock_tick_arm(Clock_Instance *ci, const struct timespec *now)
+{
+    struct timespec deadline;
+
+    if (!_clock_ticking(ci)) {
+        wheel_timer_cancel(&ci->ad->wheel, &ci->tick);
+        return;
+    }
+
+    _tick_deadline_next(ci, now, &deadline);
+    wheel_timer_add(&ci->ad->wheel, &ci->tick, _timespec_ns(&deadline));
+}
+
+/**
+ * @brief Wheel callback - a clock's displayed time has changed
+ */
+static void
+_clock_tick_cb(void *data, int64_t now)
+{
+    Clock_Instance *ci = data;
+    struct timespec ts;
+
+    if (!_clock_ticking(ci)) return;
+
+    _timer_cb(ci);
+    _timespec_from_ns(now, &ts);
+    _clock_tick_arm(ci, &ts);
+}
+
+/**
+ * @brief Renders every clock whose displayed time has changed
+ *
+ * Everything due by now fires in this one wakeup; only those clocks
+ * are rendered and re-queued.
+ */
+static void
+_tick_fire(App_Data *ad)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    wheel_advance(&ad->wheel, _timespec_ns(&now));
+}
+
+/**
+ * @brief Tick fd callback - fires whenever a displayed time changes
+ */
+static Eina_Bool
+_tick_fd_cb(void *data, Ecore_Fd_Handler *fd_handler EINA_UNUSED)
+{
+    App_Data *ad = data;
+    uint64_t expirations;
+
+    // Drain the expiration count; ECANCELED means the clock was stepped
+    // under the armed deadline, EAGAIN just means a spurious wakeup
+    if (read(ad->tick_fd, &expirations, sizeof(expirations)) < 0) {
+        if (errno == ECANCELED) _clock_jump_handle(ad);
+        return ECORE_CALLBACK_RENEW;
+    }
+
+    _tick_lateness_record(ad);
+    _tick_fire(ad);
+    _tick_arm(ad);
+
+    return ECORE_CALLBACK_RENEW;
+}
+
+/**
+ * @brief Creates the CLOCK_REALTIME timerfd used for boundary-aligned updates
+ */
+static void
+_tick_init(App_Data *ad)
+{
+    ad->tick_fd = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (ad->tick_fd < 0) {
+        fprintf(stderr, "Warning: timerfd unavailable, falling back to relative timers: %s\n", strerror(errno));
+        return;
+    }
+
+    ad->tick_handler = ecore_main_fd_handler_add(ad->tick_fd, ECORE_FD_READ,
+                                                 _tick_fd_cb, ad, NULL, NULL);
+    if (!ad->tick_handler) {
+        close(ad->tick_fd);
+        ad->tick_fd = -1;
+    }
+}
+
+/**
+ * @brief Releases the tick timerfd
+ */
+static void
+_tick_shutdown(App_Data *ad)
+{
+    if (ad->tick_handler) {
+        ecore_main_fd_handler_del(ad->tick_handler);
+        ad->tick_handler = NULL;
+    }
+    if (ad->tick_fd >= 0) {
+        close(ad->tick_fd);
+        ad->tick_fd = -1;
+    }
+}
+
+/**
+ * @brief Computes the first instant after @p now at which a clock's display changes
+ *
+ * The time text changes when its mode says so. The date changes at
+ * midnight or at a UTC offset transition, which need not fall on the
+ * mode's cadence.
+ */
+static void
+_tick_deadline_next(Clock_Instance *ci, const struct timespec *now, struct timespec *deadline)
+{
+    Mode_Ctx ctx;
+
+    _mode_ctx_get(ci, &ctx);
+    mode_get(ci->clock_mode)->next(&ctx, now, deadline);
+
+    if (ci->date.valid && ci->date.valid_until > now->tv_sec &&
+        (ci->date.valid_until < deadline->tv_sec ||
+         (ci->date.valid_until == deadline->tv_sec && deadline->tv_nsec))) {
+        deadline->tv_sec = ci->date.valid_until;
+        deadline->tv_nsec = 0;
+    }
+}
+
+/**
+ * @brief Arms the shared tick for the earliest deadline in the wheel
+ *
+ * The deadline is absolute, so main-loop latency on one tick never
+ * carries over into the next one. It is also armed cancel-on-set, so a
+ * stepped clock or a resume from suspend wakes us immediately instead
+ * of leaving a stale minute on screen.
+ */
+static void
+_tick_arm(App_Data *ad)
+{
+    struct itimerspec its;
+    int64_t deadline;
+
+    if (ad->timer) {
+        ecore_timer_del(ad->timer);
+        ad->timer = NULL;
+    }
+
+    // Nothing can be seen; _visibility_update() reschedules on resume
+    if (!wheel_next(&ad->wheel, &deadline)) return;
+    _timespec_from_ns(deadline, &ad->tick_deadline);
+
+    if (ad->tick_fd < 0) {
+        ad->timer = ecore_timer_add(_get_next_timer_interval(&ad->tick_deadline), _tick_timer_cb, ad);
+        return;
+    }
+
+    memset(&its, 0, sizeof(its));
+    its.it_value = ad->tick_deadline;
+
+    if (timerfd_settime(ad->tick_fd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET, &its, NULL) < 0) {
+        fprintf(stderr, "Warning: Could not arm tick timer: %s\n", strerror(errno));
+    }
+}
+
+/**
+ * @brief Re-queues every clock's next tick, then arms the shared tick
+ */
+static void
+_tick_schedule(App_Data *ad)
+{
+    Clock_Instance *ci;
+    struct timespec now;
+    Eina_List *l;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    EINA_LIST_FOREACH(ad->clocks, l, ci)
+        _clock_tick_arm(ci, &now);
+
+    _tick_arm(ad);
+}
+
+/**
+ * @brief Cancels any pending update
+ */
+static void
+_clock_unschedule(App_Data *ad)
+{
+    if (ad->timer) {
+        ecore_timer_del(ad->timer);
+        ad->timer = NULL;
+    }
+    if (ad->tick_fd >= 0) {
+        struct itimerspec its;
+
+        memset(&its, 0, sizeof(its));
+        timerfd_settime(ad->tick_fd, 0, &its, NULL);
+    }
+}
+
+/**
+ * @brief Sets up the update schedule for the clocks' modes and seconds preference
+ */
+static void
+_clock_schedule(App_Data *ad)
+{
+    _clock_unschedule(ad);
+    _tick_schedule(ad);
+}
+
+/**
+ * @brief Suspends or resumes a clock according to its visibility state, without rescheduling
+ * @return EINA_TRUE if the clock was suspended or resumed
+ */
+static Eina_Bool
+_visibility_apply(Clock_Instance *ci)
+{
+    App_Data *ad = ci->ad;
+    Eina_Bool hidden = ci->obscured || ci->iconified || ad->blanked;
+
+    if (hidden == ci->suspended) return EINA_FALSE;
+    ci->suspended = hidden;
+
+    if (hidden) {
+        if (ad->debug) fprintf(stderr, "DEBUG: Clock not visible, suspending updates\n");
+        ad->suspends++;
+    } else {
+        if (ad->debug) fprintf(stderr, "DEBUG: Clock visible again, resuming updates\n");
+        _timer_cb(ci); // Single catch-up render
+    }
+
+    return EINA_TRUE;
+}
+
+/**
+ * @brief Suspends or resumes a clock according to its visibility state
+ */
+static void
+_visibility_update(Clock_Instance *ci)
+{
+    // The shared tick only serves visible clocks and the published one
+    if (_visibility_apply(ci)) _clock_schedule(ci->ad);
+}
+
+/**
+ * @brief Returns the clock owning an X window, if any
+ */
+static Clock_Instance *
+_clock_find_by_xwin(App_Data *ad, Ecore_X_Window xwin)
+{
+    Clock_Instance *ci;
+    Eina_List *l;
+
+    EINA_LIST_FOREACH(ad->clocks, l, ci) {
+        if (elm_win_xwindow_get(ci->win) == xwin) return ci;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief X VisibilityNotify handler - tracks whether a clock is fully obscured
+ */
+static Eina_Bool
+_win_visibility_change_cb(void *data, int type EINA_UNUSED, void *event)
+{
+    Ecore_X_Event_Window_Visibility_Change *ev = event;
+    Clock_Instance *ci = _clock_find_by_xwin(data, ev->win);
+
+    if (!ci) return ECORE_CALLBACK_PASS_ON;
+
+    ci->obscured = !!ev->fully_obscured;
+    _visibility_update(ci);
+
+    return ECORE_CALLBACK_PASS_ON;
+}
+
+/**
+ * @brief Screensaver handler - tracks whether the display is blanked
+ */
+static Eina_Bool
+_screensaver_notify_cb(void *data, int type EINA_UNUSED, void *event)
+{
+    App_Data *ad = data;
+    Ecore_X_Event_Screensaver_Notify *ev = event;
+    Clock_Instance *ci;
+    Eina_List *l;
+    Eina_Bool changed = EINA_FALSE;
+
+    ad->blanked = !!ev->on;
+    EINA_LIST_FOREACH(ad->clocks, l, ci) {
+        if (_visibility_apply(ci)) changed = EINA_TRUE;
+    }
+
+    // Every clock changes at once; re-arm the shared tick a single time
+    if (changed) _clock_schedule(ad);
+
+    return ECORE_CALLBACK_PASS_ON;
+}
+
+/**
+ * @brief Window iconify/restore callbacks
+ */
+static void
+_win_iconified_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+    Clock_Instance *ci = data;
+
+    ci->iconified = EINA_TRUE;
+    _visibility_update(ci);
+}
+
+static void
+_win_normal_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+    Clock_Instance *ci = data;
+
+    ci->iconified = EINA_FALSE;
+    _visibility_update(ci);
+}
+
+/**
+ * @brief Starts tracking one clock window's visibility
+ */
+static void
+_clock_visibility_init(Clock_Instance *ci)
+{
+    Ecore_X_Window xwin = elm_win_xwindow_get(ci->win);
+
+    evas_object_smart_callback_add(ci->win, "iconified", _win_iconified_cb, ci);
+    evas_object_smart_callback_add(ci->win, "normal", _win_normal_cb, ci);
+
+    if (xwin) ecore_x_event_mask_set(xwin, ECORE_X_EVENT_MASK_WINDOW_VISIBILITY);
+}
+
+/**
+ * @brief Starts tracking window visibility and screen blanking for all clocks
+ */
+static void
+_visibility_init(App_Data *ad)
+{
+    Clock_Instance *ci = eina_list_data_get(ad->clocks);
+
+    if (!ci || !elm_win_xwindow_get(ci->win)) return;
+
+    ad->handlers = eina_list_append(ad->handlers,
+        ecore_event_handler_add(ECORE_X_EVENT_WINDOW_VISIBILITY_CHANGE, _win_visibility_change_cb, ad));
+
+    if (ecore_x_screensaver_event_available_get()) {
+        ecore_x_screensaver_event_listen_set(EINA_TRUE);
+        ad->handlers = eina_list_append(ad->handlers,
+            ecore_event_handler_add(ECORE_X_EVENT_SCREENSAVER_NOTIFY, _screensaver_notify_cb, ad));
+    }
+}
+
+/**
+ * @brief Removes all Ecore event handlers (visibility, drag, screen changes)
+ */
+static void
+_handlers_shutdown(App_Data *ad)
+{
+    Ecore_Event_Handler *handler;
+
+    EINA_LIST_FREE(ad->handlers, handler)
+        ecore_event_handler_del(handler);
+}
+
+/**
+ * @brief Window delete callback
+ */
+static void
+_win_del_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+    _clock_close(data);
+}
+
+/**
+ * @brief Deferred close - removes a clock, or quits when it is the last one
+ *
+ * The last clock stays in the configuration, so the next start shows
+ * it again.
+ */
+static void
+_clock_close_job_cb(void *data)
+{
+    Clock_Instance *ci = data;
+    App_Data *ad = ci->ad;
+    Config_Clock *cc = ci->config;
+
+    ci->close_job = NULL;
+
+    if (eina_list_count(ad->clocks) <= 1) {
+        ecore_main_loop_quit();
+        return;
+    }
+
+    _clock_del(ci);
+    if (cc) {
+        ad->config->clocks = eina_list_remove(ad->config->clocks, cc);
+        config_clock_free(cc);
+        _config_dirty_set(ad);
+    }
+    // The next clock may have taken over the time page
+    if (ad->timepage) _timer_cb(eina_list_data_get(ad->clocks));
+    _clock_schedule(ad);
+}
+
+/**
+ * @brief Requests that a clock be closed
+ *
+ * Runs from the clock's own window and Edje callbacks, so the window is
+ * only deleted once they have returned.
+ */
+static void
+_clock_close(Clock_Instance *ci)
+{
+    if (!ci->close_job) ci->close_job = ecore_job_add(_clock_close_job_cb, ci);
+}
+
+/**
+ * @brief Mouse down callback - starts dragging or prepares for click detection
+ */
+static void
+_mouse_down_cb(void *data, Evas *e EINA_UNUSED,
+               Evas_Object *obj EINA_UNUSED, void *event_info)
+{
+    Clock_Instance *ci = data;
+    Evas_Event_Mouse_Down *ev = event_info;
+
+    if (ev->button != 1) return;
+
+    // Record initial mouse position for click/drag detection
+    ci->mouse_down_x = ev->canvas.x;
+    ci->mouse_down_y = ev->canvas.y;
+    ci->click_suppress = EINA_FALSE; // Reset suppression flag for new click/drag
+    ci->dragging = EINA_FALSE; // Not dragging yet
+    if (!ci->wm_move_settle_timer) ci->wm_moving = EINA_FALSE; // A refused or empty WM move
+
+    // Save window position for potential drag
+    evas_object_geometry_get(ci->win, &ci->win_start_x, &ci->win_start_y, NULL, NULL);
+
+    // Save pointer root position for potential drag; the window is not
+    // moving yet, so its origin plus the canvas position is exact
+    ci->drag_start_x = ci->win_start_x + ev->canvas.x;
+    ci->drag_start_y = ci->win_start_y + ev->canvas.y;
+    // Do not grab pointer yet; only grab if drag threshold is exceeded
+}
+
+/**
+ * @brief Mouse up callback - ends dragging and allows click if no drag occurred
+ */
+static void
+_mouse_up_cb(void *data, Evas *e EINA_UNUSED,
+             Evas_Object *obj EINA_UNUSED, void *event_info)
+{
+    Clock_Instance *ci = data;
+    Evas_Event_Mouse_Up *ev = event_info;
+
+    if (ev->button != 1) return;
+
+    if (ci->dragging) {
+        ecore_x_pointer_ungrab();
+        ci->dragging = EINA_FALSE;
+        _drag_end(ci);
+        // Drag finished, persist the final position now
+        _config_save(ci);
+        _config_flush(ci->ad);
+        // click_suppress remains set, so click is not allowed after drag
+    } else {
+        // If not dragging, allow click (click_suppress should be false)
+        ci->click_suppress = EINA_FALSE;
+    }
+    // click_suppress will be reset on next mouse down
+}
+
+/**
+ * @brief Hands the move loop of a drag to the window manager or compositor
+ * @return EINA_FALSE if it could not be handed over
+ *
+ * elm_win_move_resize_start() only does anything on Wayland. On X11 the
+ * window manager is asked with a _NET_WM_MOVERESIZE client message,
+ * after releasing the implicit pointer grab of the press. Managers
+ * without _NET_WM_MOVERESIZE support ignore it and the window stays put.
+ */
+static Eina_Bool
+_wm_move_start(Clock_Instance *ci)
+{
+    Ecore_X_Window xwin = elm_win_xwindow_get(ci->win);
+    int x, y;
+
+    if (!xwin) return elm_win_move_resize_start(ci->win, ELM_WIN_MOVE_RESIZE_MOVE);
+
+    // Root position of the motion event being handled, no round trip
+    ecore_x_pointer_last_xy_get(&x, &y);
+    ecore_x_pointer_ungrab();
+    ecore_x_netwm_moveresize_request_send(xwin, x, y, ECORE_X_NETWM_DIRECTION_MOVE, 1);
+
+    return EINA_TRUE;
+}
+
+/**
+ * @brief Mouse move callback - detects the start of a drag and updates click suppression
+ *
+ * The window itself is moved by _drag_pointer_move_cb and
+ * _drag_animator_cb, which see the same motion event right after this one.
+ */
+static void
+_mouse_move_cb(void *data, Evas *e EINA_UNUSED,
+               Evas_Object *obj EINA_UNUSED, void *event_info)
+{
+    Clock_Instance *ci = data;
+    App_Data *ad = ci->ad;
+    Evas_Event_Mouse_Move *ev = event_info;
+
+    if (ev->buttons != 1) return; // Only handle left button moves
+    if (ci->dragging) return;
+
+    // Only start dragging once the pointer left the press threshold;
+    // until then, do not drag and do not suppress the click
+    if (!drag_threshold_crossed(ev->cur.canvas.x - ci->mouse_down_x,
+                                ev->cur.canvas.y - ci->mouse_down_y)) return;
+
+    ci->click_suppress = EINA_TRUE; // Suppress click if dragging
+
+    // Let the window manager run the move loop when asked to, or when
+    // there is no X window to move ourselves (Wayland)
+    if (drag_wm_wanted(ad->wm_drag, elm_win_xwindow_get(ci->win) != 0)) {
+        if (_wm_move_start(ci)) {
+            ci->wm_moving = EINA_TRUE;
+            return;
+        }
+        if (ad->debug) fprintf(stderr, "DEBUG: Window manager refused the move, dragging client-side\n");
+    }
+
+    ci->dragging = EINA_TRUE;
+
+    // Window size cannot change under us during the drag; query it once
+    evas_object_geometry_get(ci->win, NULL, NULL, &ci->drag_win_w, &ci->drag_win_h);
+    ci->drag_pending = EINA_FALSE;
+    ci->drag_events = 0;
+    ci->drag_moves = 0;
+
+    // Grab pointer now
+    Ecore_X_Window xwin = elm_win_xwindow_get(ci->win);
+    if (xwin) ecore_x_pointer_grab(xwin);
+}
+
+/**
+ * @brief Moves the window to follow the latest recorded pointer position
+ */
+static void
+_drag_apply(Clock_Instance *ci)
+{
+    App_Data *ad = ci->ad;
+
+    if (!ci->drag_pending) return;
+    ci->drag_pending = EINA_FALSE;
+
+    int new_x = ci->win_start_x + (ci->drag_pointer_x - ci->drag_start_x);
+    int new_y = ci->win_start_y + (ci->drag_pointer_y - ci->drag_start_y);
+
+    // Clamp against the output under the pointer
+    const Screen_Output *o = screens_index_lookup(&ad->screens, ci->drag_pointer_x, ci->drag_pointer_y);
+    Drag_Bounds b;
+
+    _clamp_bounds_get(ad, o, ci->drag_win_w, ci->drag_win_h, &b);
+
+    if (ad->snap_distance > 0) {
+        Screen_Output u;
+
+        // Snap to work area edges
+        screens_usable_get(&ad->screens, o, &u);
+        drag_snap(&u, ad->snap_distance, ci->drag_win_w, ci->drag_win_h, &new_x, &new_y);
+    }
+
+    drag_clamp(&b, &new_x, &new_y);
+
+    evas_object_move(ci->win, new_x, new_y);
+    ci->drag_moves++;
+
+    ci->win_x = new_x;
+    ci->win_y = new_y;
+}
+
+/**
+ * @brief Animator - applies at most one window move per display frame
+ */
+static Eina_Bool
+_drag_animator_cb(void *data)
+{
+    Clock_Instance *ci = data;
+
+    // Pointer stopped; stop ticking until it moves again
+    if (!ci->drag_pending) {
+        ci->drag_animator = NULL;
+        return ECORE_CALLBACK_CANCEL;
+    }
+
+    _drag_apply(ci);
+
+    return ECORE_CALLBACK_RENEW;
+}
+
+/**
+ * @brief Ends the current drag session, applying the final position
+ */
+static void
+_drag_end(Clock_Instance *ci)
+{
+    _drag_apply(ci);
+
+    if (ci->drag_animator) {
+        ecore_animator_del(ci->drag_animator);
+        ci->drag_animator = NULL;
+    }
+
+    if (ci->ad->debug) {
+        fprintf(stderr, "DEBUG: Drag ended: %lu motion events, %lu window moves\n",
+                ci->drag_events, ci->drag_moves);
+    }
+}
+
+/**
+ * @brief Raw pointer motion handler - records the pointer while dragging
+ *
+ * Uses the root coordinates carried by the event itself, so a drag step
+ * costs no X round trip. Only the latest position is kept; the window
+ * is moved from _drag_animator_cb once per frame.
+ */
+static Eina_Bool
+_drag_pointer_move_cb(void *data, int type EINA_UNUSED, void *event)
+{
+    Ecore_Event_Mouse_Move *ev = event;
+    Clock_Instance *ci = _clock_find_by_xwin(data, ev->window);
+
+    if (!ci || !ci->dragging) return ECORE_CALLBACK_PASS_ON;
+
+    ci->drag_pointer_x = ev->root.x;
+    ci->drag_pointer_y = ev->root.y;
+    ci->drag_pending = EINA_TRUE;
+    ci->drag_events++;
+
+    if (!ci->drag_animator) ci->drag_animator = ecore_animator_add(_drag_animator_cb, ci);
+
+    return ECORE_CALLBACK_PASS_ON;
+}
+
+/**
+ * @brief A WM-driven move has gone quiet - apply the 30% clamp to where it ended
+ */
+static Eina_Bool
+_wm_move_settle_cb(void *data)
+{
+    Clock_Instance *ci = data;
+    int x = ci->win_x, y = ci->win_y;
+
+    ci->wm_move_settle_timer = NULL;
+    ci->wm_moving = EINA_FALSE;
+
+    _clamp_window_to_output(ci);
+
+    if (ci->win_x != x || ci->win_y != y) evas_object_move(ci->win, ci->win_x, ci->win_y);
+    _config_flush(ci->ad);
+
+    return ECORE_CALLBACK_CANCEL;
+}
+
+/**
+ * @brief Callback for window move events to save position
+ */
+static void
+_win_move_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+    Clock_Instance *ci = data;
+    evas_object_geometry_get(ci->win, &ci->win_x, &ci->win_y, NULL, NULL);
+    _config_save(ci);
+
+    // The WM does not tell us when its move loop ends; wait for quiet
+    if (ci->wm_moving) {
+        if (ci->wm_move_settle_timer) {
+            ecore_timer_reset(ci->wm_move_settle_timer);
+        } else {
+            ci->wm_move_settle_timer = ecore_timer_add(WM_MOVE_SETTLE_DELAY, _wm_move_settle_cb, ci);
+        }
+    }
+}
+
+/**
+ * @brief Prints help message
+ */
+static void
+_print_help(const char *prog_name)
+{
+    printf("Elive Clock v1.0 - A beautiful desktop clock\n\n");
+    printf("Usage: %s [OPTIONS]\n\n", prog_name);
+    printf("Options:\n");
+    printf("  --debug    Enable debug output\n");
+    printf("  --normal   Create a normal window (not a desktop gadget)\n");
+    printf("  --seconds  Show seconds in the time display\n");
+    printf("  --wm-drag  Let the window manager move the window when dragging\n");
+    printf("  --snap[=PX]\n");
+    printf("             Snap to work area edges and corners while dragging\n");
+    printf("             (within PX pixels, default %d)\n", SNAP_DISTANCE_DEFAULT);
+    printf("  --beats-precision=N\n");
+    printf("             Internet Time fractional digits: 2 (@BBB.FF, default)\n");
+    printf("             or 0 (@BBB, updates every 86.4 seconds)\n");
+    printf("  --clocks=N Host at least N clocks in this process, each with its\n");
+    printf("             own mode, position and date; closing one removes it\n");
+    printf("  --mode=MODE\n");
+    printf("             Show local, utc or swatch time on every clock\n");
+    printf("  --show-date, --hide-date\n");
+    printf("             Show or hide the date on every clock\n");
+    printf("  --time-format=FMT, --date-format=FMT\n");
+    printf("             strftime() formats for every clock, saved with its\n");
+    printf("             settings; an empty FMT restores the default\n");
+    printf("  --publish-time\n");
+    printf("             Publish the first clock's time, date and mode in shared\n");
+    printf("             memory for other programs (see timepage.h)\n");
+    printf("  --help     Show this help message\n");
+    printf("\nLaunching again while a clock is running passes these options\n");
+    printf("to the running process instead of starting a second one. A\n");
+    printf("forwarded --debug turns on debug output in the running clock,\n");
+    printf("where it stays on until that clock exits.\n\n");
+}
+
+/**
+ * @brief One-shot timer for boundary-aligned ticks when timerfd is unavailable
+ */
+static Eina_Bool
+_tick_timer_cb(void *data)
+{
+    App_Data *ad = data;
+
+    _tick_lateness_record(ad);
+    _tick_fire(ad);
+
+    // This timer dies on return; arm a fresh one for the next deadline
+    ad->timer = NULL;
+    _tick_arm(ad);
+
+    return ECORE_CALLBACK_CANCEL;
+}
+
+/**
+ * @brief Computes where the window's top-left corner may go on an output
+ *
+ * The window may hang up to 30% off a bare screen edge, but never past
+ * an edge where the work area is reduced by a panel or dock (strut),
+ * so it cannot end up underneath the shelf.
+ */
+static void
+_clamp_bounds_get(App_Data *ad, const Screen_Output *output, int win_w, int win_h, Drag_Bounds *b)
+{
+    Screen_Output u;
+
+    screens_usable_get(&ad->screens, output, &u);
+    drag_bounds_get(output, &u, win_w, win_h, b);
+}
+
+/**
+ * @brief Clamp window position to fit within its output's work area and allowed clamping
+ */
+static void
+_clamp_window_position(Clock_Instance *ci, int win_w, int win_h, const Screen_Output *output)
+{
+    App_Data *ad = ci->ad;
+    int x = ci->win_x;
+    int y = ci->win_y;
+    Eina_Bool position_adjusted = EINA_FALSE;
+    Drag_Bounds b;
+
+    _clamp_bounds_get(ad, output, win_w, win_h, &b);
+
+    // Allow window to be up to 30% outside bare screen edges horizontally
+    if (x < b.min_x) {
+        if (ad->debug) fprintf(stderr, "DEBUG: Adjusting window X from %d to %d (left clamp)\n", x, b.min_x);
+        x = b.min_x;
+        position_adjusted = EINA_TRUE;
+    }
+    if (x > b.max_x) {
+        if (ad->debug) fprintf(stderr, "DEBUG: Adjusting window X from %d to %d (right clamp)\n", x, b.max_x);
+        x = b.max_x;
+        position_adjusted = EINA_TRUE;
+    }
+
+    // Allow window to be up to 30% outside bare screen edges vertically
+    if (y < b.min_y) {
+        if (ad->debug) fprintf(stderr, "DEBUG: Adjusting window Y from %d to %d (top clamp)\n", y, b.min_y);
+        y = b.min_y;
+        position_adjusted = EINA_TRUE;
+    }
+    if (y > b.max_y) {
+        if (ad->debug) fprintf(stderr, "DEBUG: Adjusting window Y from %d to %d (bottom clamp)\n", y, b.max_y);
+        y = b.max_y;
         position_adjusted = EINA_TRUE;
     }
 
-    // Allow window to be up to 30% outside the screen vertically
-    int min_y = screen_y - (int)(win_h * 0.3);
-    int max_y = screen_y + screen_h - (int)(win_h * 0.7);
-    if (y < min_y) {
-        if (ad->debug) fprintf(stderr, "DEBUG: Adjusting window Y from %d to %d (top 30%% clamp)\n", y, min_y);
-        y = min_y;
-        position_adjusted = EINA_TRUE;
+    ci->win_x = x;
+    ci->win_y = y;
+
+    if (position_adjusted) {
+        if (ad->debug) fprintf(stderr, "DEBUG: Window position adjusted to (%d, %d). Saving config.\n", ci->win_x, ci->win_y);
+        _config_save(ci);
+    }
+}
+
+/**
+ * @brief Returns the output owning the window (the one under its center)
+ */
+static const Screen_Output *
+_window_output_get(Clock_Instance *ci)
+{
+    return screens_index_lookup(&ci->ad->screens, ci->win_x + ci->win_w / 2, ci->win_y + ci->win_h / 2);
+}
+
+/**
+ * @brief Clamps the window position against the output that owns it
+ */
+static void
+_clamp_window_to_output(Clock_Instance *ci)
+{
+    _clamp_window_position(ci, ci->win_w, ci->win_h, _window_output_get(ci));
+}
+
+/**
+ * @brief Rebuilds the output geometry model
+ * @return EINA_TRUE if it differs from the previous one (its version is bumped)
+ */
+static Eina_Bool
+_screens_rebuild(App_Data *ad)
+{
+    Screen_Output fallback = { 0, 0, 0, 0, "screen" };
+    Clock_Instance *ci = eina_list_data_get(ad->clocks);
+    Ecore_X_Window root = 0;
+    Screen_Index si;
+
+    if (!ci) return EINA_FALSE;
+
+    elm_win_screen_size_get(ci->win, &fallback.x, &fallback.y, &fallback.w, &fallback.h);
+    if (elm_win_xwindow_get(ci->win)) root = ecore_x_window_root_first_get();
+
+    screens_index_build(&si, root, &fallback);
+    if (ad->screens.version && screens_index_equal(&si, &ad->screens)) return EINA_FALSE;
+
+    si.version = ad->screens.version + 1;
+    ad->screens = si;
+
+    if (ad->debug) {
+        fprintf(stderr, "DEBUG: Screen model version %u\n", si.version);
+        for (int i = 0; i < si.count; i++) {
+            const Screen_Output *o = &si.outputs[i];
+            fprintf(stderr, "DEBUG: Output %s: %dx%d+%d+%d\n", o->name, o->w, o->h, o->x, o->y);
+        }
+        if (si.has_workarea) {
+            fprintf(stderr, "DEBUG: Work area: %dx%d+%d+%d\n",
+                    si.workarea.w, si.workarea.h, si.workarea.x, si.workarea.y);
+        }
+    }
+
+    return EINA_TRUE;
+}
+
+/**
+ * @brief Debounced screen change - re-clamps only if the model really changed
+ */
+static Eina_Bool
+_screens_change_timer_cb(void *data)
+{
+    App_Data *ad = data;
+    Clock_Instance *ci;
+    Eina_List *l;
+
+    ad->screens_change_timer = NULL;
+
+    if (!_screens_rebuild(ad)) return ECORE_CALLBACK_CANCEL;
+
+    EINA_LIST_FOREACH(ad->clocks, l, ci) {
+        int x = ci->win_x, y = ci->win_y;
+
+        _clamp_window_to_output(ci);
+        if (ci->win_x != x || ci->win_y != y) evas_object_move(ci->win, ci->win_x, ci->win_y);
+    }
+
+    return ECORE_CALLBACK_CANCEL;
+}
+
+/**
+ * @brief Schedules a screen model rebuild
+ */
+static void
+_screens_change_queue(App_Data *ad)
+{
+    if (ad->screens_change_timer) {
+        ecore_timer_reset(ad->screens_change_timer);
+    } else {
+        ad->screens_change_timer = ecore_timer_add(SCREENS_CHANGE_DELAY, _screens_change_timer_cb, ad);
+    }
+}
+
+/**
+ * @brief RandR screen/CRTC/output change handler
+ */
+static Eina_Bool
+_screens_randr_change_cb(void *data, int type EINA_UNUSED, void *event EINA_UNUSED)
+{
+    _screens_change_queue(data);
+
+    return ECORE_CALLBACK_PASS_ON;
+}
+
+/**
+ * @brief Root window property handler - watches _NET_WORKAREA
+ */
+static Eina_Bool
+_screens_property_change_cb(void *data, int type EINA_UNUSED, void *event)
+{
+    Ecore_X_Event_Window_Property *ev = event;
+
+    if (ev->atom == ECORE_X_ATOM_NET_WORKAREA && ev->win == ecore_x_window_root_first_get()) {
+        _screens_change_queue(data);
+    }
+
+    return ECORE_CALLBACK_PASS_ON;
+}
+
+/**
+ * @brief Subscribes to output layout and work area changes
+ */
+static void
+_screens_watch_init(App_Data *ad)
+{
+    Clock_Instance *ci = eina_list_data_get(ad->clocks);
+    Ecore_X_Window root;
+
+    if (!ci || !elm_win_xwindow_get(ci->win)) return;
+    root = ecore_x_window_root_first_get();
+
+    ecore_x_randr_events_select(root, EINA_TRUE);
+    ecore_x_event_mask_set(root, ECORE_X_EVENT_MASK_WINDOW_PROPERTY);
+
+    ad->handlers = eina_list_append(ad->handlers,
+        ecore_event_handler_add(ECORE_X_EVENT_SCREEN_CHANGE, _screens_randr_change_cb, ad));
+    ad->handlers = eina_list_append(ad->handlers,
+        ecore_event_handler_add(ECORE_X_EVENT_RANDR_CRTC_CHANGE, _screens_randr_change_cb, ad));
+    ad->handlers = eina_list_append(ad->handlers,
+        ecore_event_handler_add(ECORE_X_EVENT_RANDR_OUTPUT_CHANGE, _screens_randr_change_cb, ad));
+    ad->handlers = eina_list_append(ad->handlers,
+        ecore_event_handler_add(ECORE_X_EVENT_WINDOW_PROPERTY, _screens_property_change_cb, ad));
+}
+
+/**
+ * @brief Places a clock where its configuration says
+ *
+ * Restores the position relative to the saved output if it still
+ * exists, otherwise the absolute one, then clamps and moves the window.
+ */
+static void
+_clock_position_restore(Clock_Instance *ci)
+{
+    Config_Clock *cc = ci->config;
+    const Screen_Output *saved = screens_index_find(&ci->ad->screens, cc->output);
+
+    ci->win_x = cc->win_x;
+    ci->win_y = cc->win_y;
+    if (saved) {
+        ci->win_x = saved->x + cc->output_x;
+        ci->win_y = saved->y + cc->output_y;
+    }
+
+    // Clamp window position to fit on its output and allowed clamping
+    _clamp_window_to_output(ci);
+
+    // Move the window to the loaded/adjusted position
+    evas_object_move(ci->win, ci->win_x, ci->win_y);
+}
+
+/**
+ * @brief Creates the window for one configured clock
+ * @return The new clock, or NULL if its theme could not be loaded
+ *
+ * Ticking is left to the shared scheduler; the clock is rendered once
+ * here so it never shows empty parts.
+ */
+static Clock_Instance *
+_clock_add(App_Data *ad, Config_Clock *cc)
+{
+    Clock_Instance *ci = calloc(1, sizeof(Clock_Instance));
+
+    if (!ci) return NULL;
+    ci->ad = ad;
+    ci->config = cc;
+    wheel_timer_init(&ci->tick, _clock_tick_cb, ci);
+    ci->show_date = cc->show_date;
+    ci->clock_mode = cc->clock_mode;
+    ci->win_x = cc->win_x;
+    ci->win_y = cc->win_y;
+    _clock_formats_compile(ci);
+
+    /* Create window */
+    ci->win = elm_win_add(NULL, "clock-elive",
+                          ad->normal_window ? ELM_WIN_BASIC : ELM_WIN_DESKTOP);
+    elm_win_title_set(ci->win, "Elive Clock");
+    elm_win_alpha_set(ci->win, EINA_TRUE);
+
+    // Always set borderless, regardless of normal_window mode
+    elm_win_borderless_set(ci->win, EINA_TRUE);
+
+    if (!ad->normal_window) {
+        elm_win_sticky_set(ci->win, EINA_TRUE);
+    }
+
+    /* Create layout */
+    ci->layout = elm_layout_add(ci->win);
+
+    if (!elm_layout_file_set(ci->layout, ad->edj_path, "clock/main")) {
+        fprintf(stderr, "ERROR: Could not load theme from %s\n", ad->edj_path);
+        evas_object_del(ci->win);
+        free(ci);
+        return NULL;
+    }
+
+    _render_init(ci);
+
+    evas_object_size_hint_weight_set(ci->layout, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+    elm_win_resize_object_add(ci->win, ci->layout);
+
+    /* Set up callbacks */
+    evas_object_smart_callback_add(ci->win, "delete,request", _win_del_cb, ci);
+    evas_object_smart_callback_add(ci->win, "move", _win_move_cb, ci); // Add move callback
+    elm_object_signal_callback_add(ci->layout, "close,clicked", "*", _close_cb, ci);
+    elm_object_signal_callback_add(ci->layout, "date,clicked", "date_event_area", _date_click_cb, ci);
+    elm_object_signal_callback_add(ci->layout, "utc_indicator,clicked", "elm", _utc_indicator_click_cb, ci);
+
+    /* Mouse event callbacks */
+    evas_object_event_callback_add(ci->layout, EVAS_CALLBACK_MOUSE_DOWN, _mouse_down_cb, ci);
+    evas_object_event_callback_add(ci->layout, EVAS_CALLBACK_MOUSE_UP, _mouse_up_cb, ci);
+    evas_object_event_callback_add(ci->layout, EVAS_CALLBACK_MOUSE_MOVE, _mouse_move_cb, ci);
+
+    // Connect EDC signal for clock mode toggle
+    elm_object_signal_callback_add(ci->layout, "clock,mode_toggle", "elm", _clock_mode_toggle_cb, ci); // New signal for cycling modes
+
+    ad->clocks = eina_list_append(ad->clocks, ci);
+
+    /* Initial update */
+    _timer_cb(ci);
+
+    /* Apply saved date visibility */
+    elm_layout_signal_emit(ci->layout, ci->show_date ? "date,show" : "date,hide", "elm");
+
+    _clock_visibility_init(ci);
+
+    /* Show window */
+    // Get minimum size from theme/layout
+    Evas_Coord min_w = 0, min_h = 0;
+    evas_object_size_hint_min_get(ci->layout, &min_w, &min_h);
+    if (min_w < 1) min_w = 300;
+    if (min_h < 1) min_h = 120;
+    evas_object_resize(ci->win, min_w, min_h);
+    evas_object_show(ci->layout); // Show layout first
+    evas_object_show(ci->win);    // Then show window to allow size negotiation
+
+    // Get actual window dimensions after it's been shown and potentially resized by the system/theme
+    evas_object_geometry_get(ci->win, NULL, NULL, &ci->win_w, &ci->win_h);
+
+    // Index the outputs once, shared by every clock
+    if (!ad->screens.version) _screens_rebuild(ad);
+    _clock_position_restore(ci);
+
+    /* Window properties */
+    elm_win_prop_focus_skip_set(ci->win, !ad->normal_window);
+
+    if (!ad->normal_window) {
+        elm_win_layer_set(ci->win, ELM_OBJECT_LAYER_BACKGROUND);
+    }
+
+    return ci;
+}
+
+/**
+ * @brief Compiles a clock's time and date formats from its configuration
+ *
+ * Falls back to the default formats when none is set or one does not
+ * compile; the default time format follows --seconds.
+ */
+static void
+_clock_formats_compile(Clock_Instance *ci)
+{
+    const char *time_fmt = ci->config ? ci->config->time_format : NULL;
+    const char *date_fmt = ci->config ? ci->config->date_format : NULL;
+
+    if (!time_fmt || !format_compile(&ci->time_format, time_fmt)) {
+        if (time_fmt) fprintf(stderr, "Warning: Could not compile time format, using the default: %s\n", time_fmt);
+        format_compile(&ci->time_format, ci->ad->show_seconds ? TIME_FORMAT_SECONDS : TIME_FORMAT_MINUTES);
     }
-    if (y > max_y) {
-        if (ad->debug) fprintf(stderr, "DEBUG: Adjusting window Y from %d to %d (bottom 30%% clamp)\n", y, max_y);
-        y = max_y;
-        position_adjusted = EINA_TRUE;
+    if (!date_fmt || !format_compile(&ci->date_format, date_fmt)) {
+        if (date_fmt) fprintf(stderr, "Warning: Could not compile date format, using the default: %s\n", date_fmt);
+        format_compile(&ci->date_format, DATE_FORMAT_DEFAULT);
     }
 
-    ad->win_x = x;
-    ad->win_y = y;
+    ci->date.valid = EINA_FALSE;
+}
 
-    if (position_adjusted) {
-        if (ad->debug) fprintf(stderr, "DEBUG: Window position adjusted to (%d, %d). Saving config.\n", ad->win_x, ad->win_y);
-        _config_save(ad);
+/**
+ * @brief Destroys a clock window, keeping its render stats for the exit summary
+ */
+static void
+_clock_del(Clock_Instance *ci)
+{
+    App_Data *ad = ci->ad;
+
+    if (ci->dragging) ecore_x_pointer_ungrab();
+    if (ci->drag_animator) ecore_animator_del(ci->drag_animator);
+    if (ci->wm_move_settle_timer) ecore_timer_del(ci->wm_move_settle_timer);
+    if (ci->close_job) ecore_job_del(ci->close_job);
+    wheel_timer_cancel(&ad->wheel, &ci->tick);
+
+    ad->render_updates += ci->render.updates;
+    ad->render_skipped += ci->render.skipped;
+
+    ad->clocks = eina_list_remove(ad->clocks, ci);
+    evas_object_del(ci->win);
+    free(ci);
+}
+
+/**
+ * @brief Parses command-line options
+ *
+ * Unknown arguments are ignored, as before, so a launch forwarded from
+ * a newer or older build never fails.
+ */
+static void
+_options_parse(Options *o, int argc, char **argv)
+{
+    memset(o, 0, sizeof(*o));
+    o->snap_distance = -1;
+    o->beats_precision = -1;
+    o->clock_mode = -1;
+    o->show_date = -1;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--debug")) {
+            o->debug = EINA_TRUE;
+        } else if (!strcmp(argv[i], "--normal")) {
+            o->normal_window = EINA_TRUE;
+        } else if (!strcmp(argv[i], "--seconds")) {
+            o->show_seconds = EINA_TRUE;
+        } else if (!strcmp(argv[i], "--wm-drag")) {
+            o->wm_drag = EINA_TRUE;
+        } else if (!strcmp(argv[i], "--snap")) {
+            o->snap_distance = SNAP_DISTANCE_DEFAULT;
+        } else if (!strncmp(argv[i], "--snap=", 7)) {
+            o->snap_distance = atoi(argv[i] + 7);
+            if (o->snap_distance < 0) o->snap_distance = 0;
+        } else if (!strncmp(argv[i], "--beats-precision=", 18)) {
+            const char *digits = argv[i] + 18;
+
+            if (!strcmp(digits, "0") || !strcmp(digits, "2")) o->beats_precision = *digits - '0';
+            else fprintf(stderr, "Warning: Unsupported beats precision '%s', expected 0 or 2\n", digits);
+        } else if (!strncmp(argv[i], "--clocks=", 9)) {
+            o->clocks_min = atoi(argv[i] + 9);
+        } else if (!strncmp(argv[i], "--mode=", 7)) {
+            o->clock_mode = mode_find(argv[i] + 7);
+            if (o->clock_mode < 0) fprintf(stderr, "Warning: Unknown clock mode '%s'\n", argv[i] + 7);
+        } else if (!strcmp(argv[i], "--show-date")) {
+            o->show_date = 1;
+        } else if (!strcmp(argv[i], "--hide-date")) {
+            o->show_date = 0;
+        } else if (!strncmp(argv[i], "--time-format=", 14)) {
+            o->time_format = argv[i] + 14;
+        } else if (!strncmp(argv[i], "--date-format=", 14)) {
+            o->date_format = argv[i] + 14;
+        } else if (!strcmp(argv[i], "--publish-time")) {
+            o->publish_time = EINA_TRUE;
+        } else if (!strcmp(argv[i], "--help")) {
+            o->help = EINA_TRUE;
+        }
+    }
+}
+
+/**
+ * @brief Applies options - at startup, or when a later launch forwards its own
+ *
+ * Flags only ever switch features on; a plain relaunch changes nothing.
+ * The window type cannot change once the first window exists.
+ */
+static void
+_options_apply(App_Data *ad, const Options *o)
+{
+    if (o->debug) ad->debug = EINA_TRUE;
+    if (o->show_seconds) ad->show_seconds = EINA_TRUE;
+    if (o->wm_drag) ad->wm_drag = EINA_TRUE;
+    if (o->snap_distance >= 0) ad->snap_distance = o->snap_distance;
+    if (o->beats_precision >= 0) ad->beats_precision = o->beats_precision;
+    if (o->clocks_min > ad->clocks_min) ad->clocks_min = o->clocks_min;
+
+    if (o->publish_time && !ad->timepage) {
+        ad->timepage = timepage_publisher_new();
+        if (!ad->timepage) fprintf(stderr, "Warning: Could not create the time page: %s\n", strerror(errno));
+    }
+
+    if (!ad->clocks) {
+        ad->normal_window = o->normal_window;
+        return;
+    }
+
+    _options_clocks_apply(ad, o);
+}
+
+/**
+ * @brief Applies the per-clock options and starts any extra clocks asked for
+ */
+static void
+_options_clocks_apply(App_Data *ad, const Options *o)
+{
+    Clock_Instance *ci;
+    Eina_List *l;
+
+    while ((int)eina_list_count(ad->config->clocks) < ad->clocks_min) {
+        Config_Clock *cc = config_clock_new(ad->config);
+
+        if (!cc) break;
+        _config_dirty_set(ad);
+        _clock_add(ad, cc);
+    }
+
+    EINA_LIST_FOREACH(ad->clocks, l, ci) {
+        if (o->clock_mode >= 0) ci->clock_mode = o->clock_mode;
+        if (o->time_format &&
+            eina_stringshare_replace(&ci->config->time_format, *o->time_format ? o->time_format : NULL)) {
+            _config_dirty_set(ad);
+        }
+        if (o->date_format &&
+            eina_stringshare_replace(&ci->config->date_format, *o->date_format ? o->date_format : NULL)) {
+            _config_dirty_set(ad);
+        }
+        _clock_formats_compile(ci);
+        if (o->show_date >= 0 && ci->show_date != o->show_date) {
+            ci->show_date = o->show_date;
+            elm_layout_signal_emit(ci->layout, ci->show_date ? "date,show" : "date,hide", "elm");
+        }
+        if (_clock_ticking(ci)) _timer_cb(ci);
+        _config_save(ci);
+    }
+
+    _clock_schedule(ad);
+}
+
+/**
+ * @brief IPC handler - a later launch forwarded its command line
+ */
+static Eina_Bool
+_ipc_client_data_cb(void *data, int type EINA_UNUSED, void *event)
+{
+    App_Data *ad = data;
+    Ecore_Ipc_Event_Client_Data *ev = event;
+    Options o;
+    char **argv;
+    int argc;
+
+    if (ecore_ipc_client_server_get(ev->client) != ad->ipc_server) return ECORE_CALLBACK_PASS_ON;
+    if (ev->major != INSTANCE_IPC_MAJOR_ARGS) return ECORE_CALLBACK_PASS_ON;
+
+    argv = instance_args_unpack(ev->data, ev->size, &argc);
+    if (argv) {
+        _options_parse(&o, argc, argv);
+        if (ad->debug || o.debug) {
+            fprintf(stderr, "DEBUG: Applying %d options forwarded by a new launch\n", argc - 1);
+        }
+        _options_apply(ad, &o);
+        free(argv);
+    }
+
+    ecore_ipc_client_send(ev->client, INSTANCE_IPC_MAJOR_ACK, 0, 0, 0, 0, NULL, 0);
+    ecore_ipc_client_flush(ev->client);
+
+    return ECORE_CALLBACK_PASS_ON;
+}
+
+/**
+ * @brief Starts listening for later launches
+ */
+static void
+_ipc_init(App_Data *ad)
+{
+    if (!ecore_ipc_init()) return;
+
+    ad->ipc_server = ecore_ipc_server_add(ECORE_IPC_LOCAL_USER, INSTANCE_IPC_NAME, 0, ad);
+    if (!ad->ipc_server) {
+        fprintf(stderr, "Warning: Could not listen for other launches; they will not be forwarded\n");
+        return;
+    }
+
+    ad->handlers = eina_list_append(ad->handlers,
+        ecore_event_handler_add(ECORE_IPC_EVENT_CLIENT_DATA, _ipc_client_data_cb, ad));
+}
+
+/**
+ * @brief Stops listening for later launches
+ */
+static void
+_ipc_shutdown(App_Data *ad)
+{
+    if (ad->ipc_server) {
+        ecore_ipc_server_del(ad->ipc_server);
+        ad->ipc_server = NULL;
+    }
+    ecore_ipc_shutdown();
+}
+
+/**
+ * @brief Re-reads config.eet and makes the clocks match it
+ *
+ * Unsaved changes are dropped. Clocks beyond those in the file are
+ * closed, and clocks only in the file are opened.
+ */
+static Eina_Bool
+_config_reload(App_Data *ad)
+{
+    Config *config, *old = ad->config;
+    Clock_Instance *ci;
+    Config_Clock *cc;
+    Eina_List *l, *ln, *lc;
+
+    // The file is about to be replaced by the write in flight
+    if (ad->config_writer) return EINA_FALSE;
+
+    config_store_map(&ad->store, ad->config_file);
+    config = config_store_load(&ad->store);
+    if (!config) return EINA_FALSE;
+
+    if (ad->config_flush_timer) {
+        ecore_timer_del(ad->config_flush_timer);
+        ad->config_flush_timer = NULL;
+    }
+    ad->config = config;
+    ad->config_dirty = EINA_FALSE;
+
+    lc = config->clocks;
+    EINA_LIST_FOREACH_SAFE(ad->clocks, l, ln, ci) {
+        cc = eina_list_data_get(lc);
+        lc = eina_list_next(lc);
+        if (!cc) {
+            _clock_del(ci);
+            continue;
+        }
+
+        ci->config = cc;
+        ci->clock_mode = cc->clock_mode;
+        _clock_formats_compile(ci);
+        if (ci->show_date != cc->show_date) {
+            ci->show_date = cc->show_date;
+            elm_layout_signal_emit(ci->layout, ci->show_date ? "date,show" : "date,hide", "elm");
+        }
+        _clock_position_restore(ci);
+        ci->batch_touched = EINA_TRUE;
+    }
+    for (; lc; lc = eina_list_next(lc))
+        _clock_add(ad, eina_list_data_get(lc));
+
+    config_clear(old);
+    free(old);
+
+    return EINA_TRUE;
+}
+
+/**
+ * @brief Parses one control line
+ * @param target Clock addressed so far in the batch; updated by "clock".
+ * @param has_cmd Set if the line yields a command ("clock" does not).
+ * @return NULL, or what is wrong with the line
+ */
+static const char *
+_control_parse(App_Data *ad, const char *line, int *target, Control_Cmd *cmd, Eina_Bool *has_cmd)
+{
+    char verb[16], arg[16];
+    int n, index;
+
+    *has_cmd = EINA_FALSE;
+    n = sscanf(line, "%15s %15s", verb, arg);
+    if (n < 1) return "empty command";
+
+    if (!strcmp(verb, "clock")) {
+        if (n < 2) return "usage: clock N|all";
+        if (!strcmp(arg, "all")) {
+            *target = -1;
+            return NULL;
+        }
+        if (sscanf(arg, "%d", &index) != 1 || index < 0 || index >= (int)eina_list_count(ad->clocks)) {
+            return "no such clock";
+        }
+        *target = index;
+        return NULL;
+    }
+
+    memset(cmd, 0, sizeof(*cmd));
+    cmd->clock = *target;
+    *has_cmd = EINA_TRUE;
+
+    if (!strcmp(verb, "query")) {
+        cmd->op = CONTROL_QUERY;
+    } else if (!strcmp(verb, "stats")) {
+        cmd->op = CONTROL_STATS;
+    } else if (!strcmp(verb, "reload")) {
+        cmd->op = CONTROL_RELOAD;
+    } else if (!strcmp(verb, "mode")) {
+        cmd->op = CONTROL_MODE;
+        if (n < 2) return "usage: mode local|utc|swatch|next";
+        cmd->a = !strcmp(arg, "next") ? CONTROL_MODE_NEXT : mode_find(arg);
+        if (cmd->a == -1) return "usage: mode local|utc|swatch|next";
+    } else if (!strcmp(verb, "date")) {
+        cmd->op = CONTROL_DATE;
+        if (n < 2) return "usage: date show|hide|toggle";
+        if (!strcmp(arg, "show")) cmd->a = 1;
+        else if (!strcmp(arg, "hide")) cmd->a = 0;
+        else if (!strcmp(arg, "toggle")) cmd->a = CONTROL_DATE_TOGGLE;
+        else return "usage: date show|hide|toggle";
+    } else if (!strcmp(verb, "move")) {
+        cmd->op = CONTROL_MOVE;
+        if (sscanf(line, "%*s %d %d", &cmd->a, &cmd->b) != 2) return "usage: move X Y";
+    } else {
+        return "unknown command";
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Applies a per-clock control command to one clock
+ *
+ * Changes are only recorded here; the batch renders and saves once.
+ */
+static void
+_control_clock_apply(Clock_Instance *ci, int index, const Control_Cmd *cmd, Eina_Strbuf *reply)
+{
+    const Screen_Output *o;
+    Eina_Bool show;
+
+    switch (cmd->op) {
+        case CONTROL_QUERY:
+            o = ci->ad->screens.count ? _window_output_get(ci) : NULL;
+            eina_strbuf_append_printf(reply, "clock %d: mode=%s date=%s x=%d y=%d output=%s visible=%s\n",
+                                      index,
+                                      mode_get(ci->clock_mode)->name,
+                                      ci->show_date ? "shown" : "hidden",
+                                      ci->win_x, ci->win_y, o ? o->name : "",
+                                      ci->suspended ? "no" : "yes");
+            break;
+        case CONTROL_MODE:
+            if (cmd->a == CONTROL_MODE_NEXT) {
+                ci->clock_mode = mode_next(ci->clock_mode);
+            } else {
+                ci->clock_mode = cmd->a;
+            }
+            ci->batch_touched = EINA_TRUE;
+            break;
+        case CONTROL_DATE:
+            show = cmd->a == CONTROL_DATE_TOGGLE ? !ci->show_date : !!cmd->a;
+            if (show != ci->show_date) {
+                ci->show_date = show;
+                elm_layout_signal_emit(ci->layout, ci->show_date ? "date,show" : "date,hide", "elm");
+            }
+            ci->batch_touched = EINA_TRUE;
+            break;
+        case CONTROL_MOVE:
+            ci->win_x = cmd->a;
+            ci->win_y = cmd->b;
+            _clamp_window_to_output(ci);
+            evas_object_move(ci->win, ci->win_x, ci->win_y);
+            ci->batch_touched = EINA_TRUE;
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Appends runtime statistics, one "key: value" per line
+ */
+static void
+_control_stats(App_Data *ad, Eina_Strbuf *reply)
+{
+    const Tick_Stats *ts = &ad->tick_stats;
+    unsigned long updates = ad->render_updates, skipped = ad->render_skipped;
+    Clock_Instance *ci;
+    Eina_List *l;
+
+    EINA_LIST_FOREACH(ad->clocks, l, ci) {
+        updates += ci->render.updates;
+        skipped += ci->render.skipped;
+    }
+
+    eina_strbuf_append_printf(reply, "clocks: %u\n", eina_list_count(ad->clocks));
+    eina_strbuf_append_printf(reply, "ticks: %lu\n", ts->ticks);
+    eina_strbuf_append_printf(reply, "tick_late_avg_ms: %.3f\n",
+                              ts->ticks ? ts->total_late_ns / 1e6 / ts->ticks : 0.0);
+    eina_strbuf_append_printf(reply, "tick_late_max_ms: %.3f\n", ts->max_late_ns / 1e6);
+    eina_strbuf_append_printf(reply, "clock_jumps: %lu\n", ts->clock_jumps);
+    eina_strbuf_append_printf(reply, "suspends: %lu\n", ad->suspends);
+    eina_strbuf_append_printf(reply, "render_updates: %lu\n", updates);
+    eina_strbuf_append_printf(reply, "render_skipped: %lu\n", skipped);
+    eina_strbuf_append_printf(reply, "config_writes: %lu\n", ad->config_writes);
+    eina_strbuf_append_printf(reply, "screens_version: %u\n", ad->screens.version);
+}
+
+/**
+ * @brief Control socket batch - validates every line, then applies them all
+ *
+ * Nothing is applied if any line is malformed. However many commands
+ * the batch holds, each touched clock is rendered and saved once, the
+ * tick is re-armed once and the configuration is flushed once.
+ */
+static void
+_control_batch_cb(void *data, char **lines, int count, Eina_Strbuf *reply)
+{
+    App_Data *ad = data;
+    Control_Cmd *cmds;
+    Clock_Instance *ci;
+    Eina_List *l;
+    Eina_Bool has_cmd, reschedule = EINA_FALSE;
+    int ncmds = 0, target = 0, errors = 0;
+    const char *err;
+
+    cmds = calloc(count ? count : 1, sizeof(Control_Cmd));
+    if (!cmds) {
+        eina_strbuf_append(reply, "error: out of memory\n");
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        err = _control_parse(ad, lines[i], &target, &cmds[ncmds], &has_cmd);
+        if (err) {
+            eina_strbuf_append_printf(reply, "error: line %d: %s: %s\n", i + 1, lines[i], err);
+            free(cmds);
+            return;
+        }
+        if (has_cmd) ncmds++;
     }
+
+    for (int i = 0; i < ncmds; i++) {
+        const Control_Cmd *cmd = &cmds[i];
+        int index = 0;
+
+        if (cmd->op == CONTROL_STATS) {
+            _control_stats(ad, reply);
+            continue;
+        }
+        if (cmd->op == CONTROL_RELOAD) {
+            if (!_config_reload(ad)) {
+                eina_strbuf_append(reply, "error: reload: config.eet unreadable or being written\n");
+                errors++;
+            }
+            reschedule = EINA_TRUE;
+            continue;
+        }
+        if (cmd->op == CONTROL_MODE) reschedule = EINA_TRUE;
+
+        // A reload earlier in the batch may have closed the clock
+        if (cmd->clock >= (int)eina_list_count(ad->clocks)) {
+            eina_strbuf_append_printf(reply, "error: clock %d: no such clock\n", cmd->clock);
+            errors++;
+            continue;
+        }
+
+        EINA_LIST_FOREACH(ad->clocks, l, ci) {
+            if (cmd->clock < 0 || cmd->clock == index) _control_clock_apply(ci, index, cmd, reply);
+            index++;
+        }
+    }
+    free(cmds);
+
+    EINA_LIST_FOREACH(ad->clocks, l, ci) {
+        if (!ci->batch_touched) continue;
+        ci->batch_touched = EINA_FALSE;
+        if (_clock_ticking(ci)) _timer_cb(ci);
+        _config_save(ci);
+    }
+    if (reschedule) _clock_schedule(ad);
+    _config_flush(ad);
+
+    if (errors) eina_strbuf_append_printf(reply, "error: %d commands failed\n", errors);
+    else eina_strbuf_append(reply, "ok\n");
+}
+
+/**
+ * @brief Starts the local control socket
+ */
+static void
+_control_init(App_Data *ad)
+{
+    char path[PATH_MAX];
+
+    control_socket_path_get(path, sizeof(path));
+    ad->control = control_server_add(path, _control_batch_cb, ad);
+    if (ad->control && ad->debug) fprintf(stderr, "DEBUG: Control socket at %s\n", path);
 }
 
 /**
- * @brief Main entry point
+ * @brief Main entry point, once this process is known to be the running instance
  */
 EAPI_MAIN int
 elm_main(int argc, char **argv)
 {
     App_Data *ad;
-    char edj_path[PATH_MAX];
+    Config_Clock *cc;
+    Eina_List *l;
+    Options opts;
     const char *theme_locations[] = {
         DATA_DIR "/themes/default.edj",
         "data/default.edj",
@@ -647,51 +2532,33 @@ elm_main(int argc, char **argv)
         NULL
     };
     Eina_Bool theme_found = EINA_FALSE;
+    struct timespec now;
 
     /* Initialize */
     eet_init();
     ad = calloc(1, sizeof(App_Data));
+    ad->tick_fd = -1;
+    clock_gettime(CLOCK_REALTIME, &now);
+    wheel_init(&ad->wheel, _timespec_ns(&now));
+    ad->beats_precision = 2;
 
     /* Parse arguments */
-    for (int i = 1; i < argc; i++) {
-        if (!strcmp(argv[i], "--debug")) {
-            ad->debug = EINA_TRUE;
-        } else if (!strcmp(argv[i], "--normal")) {
-            ad->normal_window = EINA_TRUE;
-        } else if (!strcmp(argv[i], "--seconds")) {
-            ad->show_seconds = EINA_TRUE;
-        } else if (!strcmp(argv[i], "--help")) {
-            _print_help(argv[0]);
-            free(ad);
-            eet_shutdown();
-            return 0;
-        }
-    }
+    _options_parse(&opts, argc, argv);
+    _options_apply(ad, &opts);
 
     /* Load configuration */
     _config_init(ad);
 
-    /* Create window */
-    ad->win = elm_win_add(NULL, "clock-elive",
-                          ad->normal_window ? ELM_WIN_BASIC : ELM_WIN_DESKTOP);
-    elm_win_title_set(ad->win, "Elive Clock");
-    elm_win_autodel_set(ad->win, EINA_TRUE);
-    elm_win_alpha_set(ad->win, EINA_TRUE);
-
-    // Always set borderless, regardless of normal_window mode
-    elm_win_borderless_set(ad->win, EINA_TRUE);
-
-    if (!ad->normal_window) {
-        elm_win_sticky_set(ad->win, EINA_TRUE);
+    /* Read the local zone once; its transitions drive date changes */
+    ad->local_zone = tz_zone_get(NULL);
+    if (!ad->local_zone && ad->debug) {
+        fprintf(stderr, "DEBUG: Local zone unreadable, using the C library's\n");
     }
 
-    /* Create layout */
-    ad->layout = elm_layout_add(ad->win);
-
     /* Find theme file */
     for (int i = 0; theme_locations[i]; i++) {
         if (ecore_file_exists(theme_locations[i])) {
-            snprintf(edj_path, sizeof(edj_path), "%s", theme_locations[i]);
+            snprintf(ad->edj_path, sizeof(ad->edj_path), "%s", theme_locations[i]);
             theme_found = EINA_TRUE;
             break;
         }
@@ -706,90 +2573,97 @@ elm_main(int argc, char **argv)
         return 1;
     }
 
-    if (!elm_layout_file_set(ad->layout, edj_path, "clock/main")) {
-        fprintf(stderr, "ERROR: Could not load theme from %s\n", edj_path);
+    /* One shared timer drives every clock */
+    _tick_init(ad);
+
+    /* Create one window per configured clock */
+    EINA_LIST_FOREACH(ad->config->clocks, l, cc)
+        _clock_add(ad, cc);
+
+    if (!ad->clocks) {
+        _tick_shutdown(ad);
         _config_shutdown(ad);
         elm_exit();
         free(ad);
         eet_shutdown();
         return 1;
     }
+    _options_clocks_apply(ad, &opts);
 
-    evas_object_size_hint_weight_set(ad->layout, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
-    elm_win_resize_object_add(ad->win, ad->layout);
-
-    /* Set up callbacks */
-    evas_object_smart_callback_add(ad->win, "delete,request", _win_del_cb, ad);
-    evas_object_smart_callback_add(ad->win, "move", _win_move_cb, ad); // Add move callback
-    elm_object_signal_callback_add(ad->layout, "close,clicked", "*", _close_cb, ad);
-    elm_object_signal_callback_add(ad->layout, "date,clicked", "date_event_area", _date_click_cb, ad);
-    elm_object_signal_callback_add(ad->layout, "utc_indicator,clicked", "elm", _utc_indicator_click_cb, ad);
-
-    /* Mouse event callbacks */
-    evas_object_event_callback_add(ad->layout, EVAS_CALLBACK_MOUSE_DOWN, _mouse_down_cb, ad);
-    evas_object_event_callback_add(ad->layout, EVAS_CALLBACK_MOUSE_UP, _mouse_up_cb, ad);
-    evas_object_event_callback_add(ad->layout, EVAS_CALLBACK_MOUSE_MOVE, _mouse_move_cb, ad);
-
-    // Connect EDC signal for clock mode toggle
-    elm_object_signal_callback_add(ad->layout, "clock,mode_toggle", "elm", _clock_mode_toggle_cb, ad); // New signal for cycling modes
+    ad->handlers = eina_list_append(ad->handlers,
+        ecore_event_handler_add(ECORE_EVENT_MOUSE_MOVE, _drag_pointer_move_cb, ad));
+    _visibility_init(ad);
+    _screens_watch_init(ad);
+    _ipc_init(ad);
+    _control_init(ad);
 
-    /* Initial update */
-    _timer_cb(ad);
+    _clock_schedule(ad);
 
-    /* Apply saved date visibility */
-    elm_layout_signal_emit(ad->layout, ad->show_date ? "date,show" : "date,hide", "elm");
+    /* Main loop */
+    elm_run();
 
-    /* Set up initial timer based on config and arguments */
-    if (ad->clock_mode == CLOCK_MODE_SWATCH) {
-        ad->timer = ecore_timer_add(TIMER_INTERVAL_SECONDS, _timer_cb, ad);
-    } else {
-        if (ad->show_seconds) {
-            ad->timer = ecore_timer_add(TIMER_INTERVAL_SECONDS, _timer_cb, ad);
-        } else {
-            double interval = _get_next_timer_interval(ad->show_seconds);
-            ad->timer = ecore_timer_add(interval, _minute_timer_cb, ad);
+    /* Cleanup */
+    if (ad->screens_change_timer) ecore_timer_del(ad->screens_change_timer);
+    _clock_unschedule(ad);
+    _handlers_shutdown(ad);
+    _ipc_shutdown(ad);
+    control_server_del(ad->control);
+    timepage_publisher_del(ad->timepage);
+    _tick_shutdown(ad);
+    _config_shutdown(ad);
+    while (ad->clocks)
+        _clock_del(eina_list_data_get(ad->clocks));
+    tz_shutdown();
+
+    if (ad->debug) {
+        fprintf(stderr, "DEBUG: Render stage pushed %lu part updates, skipped %lu unchanged\n",
+                ad->render_updates, ad->render_skipped);
+        if (ad->tick_stats.ticks) {
+            fprintf(stderr, "DEBUG: %lu aligned ticks, lateness avg %.3f ms, max %.3f ms\n",
+                    ad->tick_stats.ticks,
+                    ad->tick_stats.total_late_ns / 1e6 / ad->tick_stats.ticks,
+                    ad->tick_stats.max_late_ns / 1e6);
         }
+        fprintf(stderr, "DEBUG: %lu realtime clock jumps handled\n", ad->tick_stats.clock_jumps);
+        fprintf(stderr, "DEBUG: Updates suspended %lu times while not visible\n", ad->suspends);
     }
+    free(ad);
+    eet_shutdown();
 
-    /* Show window */
-    // Get minimum size from theme/layout
-    Evas_Coord min_w = 0, min_h = 0;
-    evas_object_size_hint_min_get(ad->layout, &min_w, &min_h);
-    if (min_w < 1) min_w = 300;
-    if (min_h < 1) min_h = 120;
-    evas_object_resize(ad->win, min_w, min_h);
-    evas_object_show(ad->layout); // Show layout first
-    evas_object_show(ad->win);    // Then show window to allow size negotiation
-
-    // Get actual window dimensions after it's been shown and potentially resized by the system/theme
-    int win_w, win_h;
-    evas_object_geometry_get(ad->win, NULL, NULL, &win_w, &win_h);
-
-    // Get screen geometry (x, y, width, height)
-    int screen_x, screen_y, screen_w, screen_h;
-    elm_win_screen_size_get(ad->win, &screen_x, &screen_y, &screen_w, &screen_h);
-
-    // Clamp window position to fit on screen and allowed clamping
-    _clamp_window_position(ad, win_w, win_h, screen_x, screen_y, screen_w, screen_h);
+    return 0;
+}
 
-    // Move the window to the loaded/adjusted position
-    evas_object_move(ad->win, ad->win_x, ad->win_y);
+/**
+ * @brief Process entry point
+ *
+ * A launch while another instance is running hands its options over
+ * and exits before Elementary is ever initialized.
+ */
+int
+main(int argc, char **argv)
+{
+    char lock_path[PATH_MAX];
+    Options opts;
+    int ret;
+
+    _options_parse(&opts, argc, argv);
+    if (opts.help) {
+        _print_help(argv[0]);
+        return 0;
+    }
 
-    /* Window properties */
-    elm_win_prop_focus_skip_set(ad->win, !ad->normal_window);
+    _config_dir_get(lock_path, sizeof(lock_path) - INSTANCE_LOCK_SUFFIX_LEN);
+    strcat(lock_path, INSTANCE_LOCK_SUFFIX);
 
-    if (!ad->normal_window) {
-        elm_win_layer_set(ad->win, ELM_OBJECT_LAYER_BACKGROUND);
+    if (!instance_lock(lock_path)) {
+        if (instance_handoff(argc, argv, INSTANCE_HANDOFF_TIMEOUT)) return 0;
+        fprintf(stderr, "ERROR: Another instance is running but did not answer\n");
+        return 1;
     }
 
-    /* Main loop */
-    elm_run();
-
-    /* Cleanup */
-    _config_shutdown(ad);
-    free(ad);
-    eet_shutdown();
+    elm_init(argc, argv);
+    ret = elm_main(argc, argv);
+    elm_shutdown();
 
-    return 0;
+    return ret;
 }
-ELM_MAIN()
@@ -0,0 +1,149 @@
+/**
+ * @file mode.c
+ * @brief Clock display modes
+ */
+
+#include <string.h>
+
+#include "mode.h"
+#include "tables.h"
+
+// Wall-clock tick periods (seconds) for boundary-aligned updates
+#define TICK_PERIOD_SECONDS 1
+#define TICK_PERIOD_MINUTES 60
+
+// Swatch Internet Time units in nanoseconds (1 day = 1000 beats)
+#define NSEC_PER_SEC       1000000000LL
+#define SWATCH_BEAT_NS     86400000000LL
+#define SWATCH_CENTIBEAT_NS  864000000LL
+#define SWATCH_BMT_OFFSET_NS (3600LL * NSEC_PER_SEC) // Biel Mean Time is UTC+1
+
+struct tm *
+mode_local_time(const Tz_Zone *zone, time_t t, struct tm *tm)
+{
+    Tz_Info info;
+
+    if (!zone) return localtime_r(&t, tm);
+
+    tz_localtime(zone, t, tm, &info);
+    return tm;
+}
+
+/**
+ * @brief Next multiple of @p unit_ns after @p now, counted from @p offset_ns before the epoch
+ */
+static void
+_mode_boundary_next(const struct timespec *now, long long unit_ns, long long offset_ns,
+                    struct timespec *deadline)
+{
+    long long t = (long long)now->tv_sec * NSEC_PER_SEC + now->tv_nsec + offset_ns;
+
+    t = (t / unit_ns + 1) * unit_ns - offset_ns;
+
+    deadline->tv_sec = t / NSEC_PER_SEC;
+    deadline->tv_nsec = t % NSEC_PER_SEC;
+}
+
+/**
+ * @brief Formatted time changes on whole seconds or minutes, per the finest field used
+ */
+static void
+_mode_format_next(const Mode_Ctx *ctx, const struct timespec *now, struct timespec *deadline)
+{
+    long long unit = ctx->time_format->resolution < FORMAT_RES_MINUTE ?
+                     TICK_PERIOD_SECONDS : TICK_PERIOD_MINUTES;
+
+    _mode_boundary_next(now, unit * NSEC_PER_SEC, 0, deadline);
+}
+
+static void
+_mode_local_render(const Mode_Ctx *ctx, const struct timespec *now, struct tm *date_tm,
+                   char *buf, size_t len)
+{
+    mode_local_time(ctx->zone, now->tv_sec, date_tm);
+    format_exec(ctx->time_format, date_tm, buf, len);
+}
+
+static void
+_mode_utc_render(const Mode_Ctx *ctx, const struct timespec *now, struct tm *date_tm,
+                 char *buf, size_t len)
+{
+    gmtime_r(&now->tv_sec, date_tm);
+    format_exec(ctx->time_format, date_tm, buf, len);
+}
+
+/**
+ * @brief Swatch Internet Time (@beats), with the local date
+ *
+ * Works in integer nanoseconds so the displayed centibeat changes exactly
+ * on its 0.864 s boundary rather than on whole seconds.
+ */
+static void
+_mode_swatch_render(const Mode_Ctx *ctx, const struct timespec *now, struct tm *date_tm,
+                    char *buf, size_t len)
+{
+    // Nanoseconds since midnight BMT (UTC+1); a day is a whole number of
+    // centibeats, so this also handles the day wrap-around
+    long long ns_bmt = ((long long)now->tv_sec * NSEC_PER_SEC + now->tv_nsec + SWATCH_BMT_OFFSET_NS) %
+                       (86400LL * NSEC_PER_SEC);
+    int centibeats = (int)(ns_bmt / SWATCH_CENTIBEAT_NS);
+    int beats = centibeats / 100;
+    char text[8];
+    size_t n = 4;
+
+    mode_local_time(ctx->zone, now->tv_sec, date_tm);
+
+    // Format as @BBB, or @BBB.FF
+    text[0] = '@';
+    text[1] = '0' + beats / 100;
+    tables_num2_put(text + 2, beats % 100, '0');
+    if (ctx->beats_precision > 0) {
+        text[4] = '.';
+        tables_num2_put(text + 5, centibeats % 100, '0');
+        n = 7;
+    }
+
+    if (!len) return;
+    if (n >= len) n = len - 1;
+    memcpy(buf, text, n);
+    buf[n] = '\0';
+}
+
+/**
+ * @brief Changes on centibeats (every 0.864 s) or whole beats (every 86.4 s) from midnight BMT
+ */
+static void
+_mode_swatch_next(const Mode_Ctx *ctx, const struct timespec *now, struct timespec *deadline)
+{
+    _mode_boundary_next(now, ctx->beats_precision > 0 ? SWATCH_CENTIBEAT_NS : SWATCH_BEAT_NS,
+                        SWATCH_BMT_OFFSET_NS, deadline);
+}
+
+static const Mode _modes[MODE_LAST] = {
+    [MODE_LOCAL] = { "local", "", NULL, EINA_FALSE, _mode_local_render, _mode_format_next },
+    [MODE_UTC] = { "utc", "UTC", NULL, EINA_TRUE, _mode_utc_render, _mode_format_next },
+    [MODE_SWATCH] = { "swatch", "Internet Time", "https://internettime.elivecd.org/", EINA_FALSE,
+                      _mode_swatch_render, _mode_swatch_next },
+};
+
+const Mode *
+mode_get(int id)
+{
+    return id >= 0 && id < MODE_LAST ? &_modes[id] : &_modes[MODE_LOCAL];
+}
+
+int
+mode_find(const char *name)
+{
+    for (int m = 0; m < MODE_LAST; m++) {
+        if (!strcmp(name, _modes[m].name)) return m;
+    }
+
+    return -1;
+}
+
+int
+mode_next(int id)
+{
+    return id >= 0 && id < MODE_LAST - 1 ? id + 1 : 0;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file mode.h
+ * @brief Clock display modes
+ *
+ * Each mode renders the time text, names its indicator and says when
+ * its output next changes. The scheduler only ever asks a mode for its
+ * next deadline, so a mode wakes the clock exactly as often as its text
+ * changes and adding one needs no timer code. Modes are cycled in
+ * registration order.
+ */
+
+#ifndef MODE_H
+#define MODE_H
+
+#include <Eina.h>
+#include <time.h>
+
+#include "tz.h"
+#include "format.h"
+
+/**
+ * @brief Mode ids, stored in config.eet; append new modes, never reorder
+ */
+typedef enum {
+    MODE_LOCAL,
+    MODE_UTC,
+    MODE_SWATCH,
+    MODE_LAST
+} Mode_Id;
+
+/**
+ * @brief Per-clock state a mode works from
+ */
+typedef struct _Mode_Ctx {
+    const Tz_Zone *zone;            // Local zone, or NULL for localtime_r()
+    const Format *time_format;
+    int beats_precision;            // Swatch fractional digits, 2 or 0
+} Mode_Ctx;
+
+typedef struct _Mode {
+    const char *name;               // As used by --mode and the control socket
+    const char *indicator;          // Indicator label
+    const char *link;               // Opened on an indicator click, or NULL
+    Eina_Bool date_utc;             // The date is shown in UTC, not local time
+
+    /**
+     * @brief Formats the time at @p now into @p buf
+     * @param date_tm Set to @p now broken down in the zone the date is shown in.
+     */
+    void (*render)(const Mode_Ctx *ctx, const struct timespec *now, struct tm *date_tm,
+                   char *buf, size_t len);
+
+    /**
+     * @brief Sets @p deadline to the first instant after @p now at which the text changes
+     */
+    void (*next)(const Mode_Ctx *ctx, const struct timespec *now, struct timespec *deadline);
+} Mode;
+
+/**
+ * @brief Returns mode @p id, or the local mode if there is no such mode
+ */
+const Mode *mode_get(int id);
+
+/**
+ * @brief Returns the id of the mode called @p name, or -1
+ */
+int mode_find(const char *name);
+
+/**
+ * @brief Returns the id of the mode a click on mode @p id switches to
+ */
+int mode_next(int id);
+
+/**
+ * @brief localtime_r() through the zone engine, when @p zone is set
+ */
+struct tm *mode_local_time(const Tz_Zone *zone, time_t t, struct tm *tm);
+
+#endif /* MODE_H */
@@ -0,0 +1,19 @@
+/**
+ * @file screen_geometry.h
+ * @brief Plain output geometry, shared by code that must not need EFL
+ */
+
+#ifndef SCREEN_GEOMETRY_H
+#define SCREEN_GEOMETRY_H
+
+#define SCREEN_NAME_MAX    32
+
+/**
+ * @brief Geometry of a single output (monitor) in root window coordinates
+ */
+typedef struct _Screen_Output {
+    int x, y, w, h;
+    char name[SCREEN_NAME_MAX];     // RandR output name, e.g. "DP-1"
+} Screen_Output;
+
+#endif /* SCREEN_GEOMETRY_H */
@@ -0,0 +1,268 @@
+/**
+ * @file screens.c
+ * @brief Per-output screen geometry index
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "screens.h"
+
+/**
+ * @brief Appends an output, ignoring empty or duplicate (cloned) geometry
+ */
+static void
+_screens_output_add(Screen_Index *si, int x, int y, int w, int h, const char *name)
+{
+    if (w <= 0 || h <= 0 || si->count >= SCREEN_OUTPUTS_MAX) return;
+
+    for (int i = 0; i < si->count; i++) {
+        const Screen_Output *o = &si->outputs[i];
+        if (o->x == x && o->y == y && o->w == w && o->h == h) return;
+    }
+
+    Screen_Output *o = &si->outputs[si->count++];
+    o->x = x;
+    o->y = y;
+    o->w = w;
+    o->h = h;
+    snprintf(o->name, sizeof(o->name), "%s", name);
+}
+
+/**
+ * @brief Collects outputs from RandR
+ */
+static void
+_screens_randr_collect(Screen_Index *si, Ecore_X_Window root)
+{
+    Ecore_X_Randr_Output *outputs;
+    int num = 0;
+
+    if (!ecore_x_randr_query()) return;
+
+    outputs = ecore_x_randr_outputs_get(root, &num);
+    if (!outputs) return;
+
+    for (int i = 0; i < num; i++) {
+        Ecore_X_Randr_Crtc crtc = ecore_x_randr_output_crtc_get(root, outputs[i]);
+        int x, y, w, h, len = 0;
+        char *name;
+
+        if (!crtc) continue; // Disconnected or disabled
+
+        ecore_x_randr_crtc_geometry_get(root, crtc, &x, &y, &w, &h);
+        name = ecore_x_randr_output_name_get(root, outputs[i], &len);
+        _screens_output_add(si, x, y, w, h, name ? name : "");
+        free(name);
+    }
+
+    free(outputs);
+}
+
+/**
+ * @brief Collects outputs from Xinerama
+ */
+static void
+_screens_xinerama_collect(Screen_Index *si)
+{
+    int num = ecore_x_xinerama_screen_count_get();
+
+    for (int i = 0; i < num; i++) {
+        char name[SCREEN_NAME_MAX];
+        int x, y, w, h;
+
+        if (!ecore_x_xinerama_screen_geometry_get(i, &x, &y, &w, &h)) continue;
+        snprintf(name, sizeof(name), "xinerama-%d", i);
+        _screens_output_add(si, x, y, w, h, name);
+    }
+}
+
+/**
+ * @brief Reads the first desktop's _NET_WORKAREA from the root window
+ */
+static void
+_screens_workarea_read(Screen_Index *si, Ecore_X_Window root)
+{
+    unsigned int num = 0;
+    int *areas;
+
+    areas = ecore_x_netwm_desk_workareas_get(root, &num);
+    if (areas && num >= 4 && areas[2] > 0 && areas[3] > 0) {
+        si->workarea.x = areas[0];
+        si->workarea.y = areas[1];
+        si->workarea.w = areas[2];
+        si->workarea.h = areas[3];
+        snprintf(si->workarea.name, sizeof(si->workarea.name), "workarea");
+        si->has_workarea = EINA_TRUE;
+    }
+    free(areas);
+}
+
+/**
+ * @brief Inserts a value into a sorted array of distinct values
+ */
+static void
+_screens_edge_add(int *edges, int *n, int v)
+{
+    int i = *n;
+
+    for (int j = 0; j < *n; j++) {
+        if (edges[j] == v) return;
+    }
+    while (i > 0 && edges[i - 1] > v) {
+        edges[i] = edges[i - 1];
+        i--;
+    }
+    edges[i] = v;
+    (*n)++;
+}
+
+/**
+ * @brief Squared distance from a point to an output rectangle
+ */
+static long long
+_screens_distance_sq(const Screen_Output *o, int x, int y)
+{
+    long long dx = 0, dy = 0;
+
+    if (x < o->x) dx = o->x - x;
+    else if (x >= o->x + o->w) dx = x - (o->x + o->w - 1);
+    if (y < o->y) dy = o->y - y;
+    else if (y >= o->y + o->h) dy = y - (o->y + o->h - 1);
+
+    return dx * dx + dy * dy;
+}
+
+/**
+ * @brief Returns the index of the output nearest to (x, y)
+ */
+static int
+_screens_nearest(const Screen_Index *si, int x, int y)
+{
+    long long best = LLONG_MAX;
+    int best_i = 0;
+
+    for (int i = 0; i < si->count; i++) {
+        long long d = _screens_distance_sq(&si->outputs[i], x, y);
+        if (d < best) {
+            best = d;
+            best_i = i;
+        }
+    }
+
+    return best_i;
+}
+
+/**
+ * @brief Finds the cell containing @p v along one axis
+ */
+static int
+_screens_cell_find(const int *edges, int n, int v)
+{
+    int lo = 0, hi = n - 2;
+
+    // Points past the outer edges belong to the border cells
+    if (v < edges[0]) return 0;
+    if (v >= edges[n - 1]) return hi;
+
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (edges[mid] <= v) lo = mid;
+        else hi = mid - 1;
+    }
+
+    return lo;
+}
+
+void
+screens_index_build(Screen_Index *si, Ecore_X_Window root, const Screen_Output *fallback)
+{
+    memset(si, 0, sizeof(*si));
+
+    if (root) {
+        _screens_randr_collect(si, root);
+        if (!si->count) _screens_xinerama_collect(si);
+        _screens_workarea_read(si, root);
+    }
+    if (!si->count) {
+        _screens_output_add(si, fallback->x, fallback->y, fallback->w, fallback->h, fallback->name);
+    }
+    if (!si->count) {
+        // Nothing sane at all; keep lookups well-defined
+        _screens_output_add(si, 0, 0, 1, 1, "");
+    }
+
+    for (int i = 0; i < si->count; i++) {
+        const Screen_Output *o = &si->outputs[i];
+        _screens_edge_add(si->xs, &si->nx, o->x);
+        _screens_edge_add(si->xs, &si->nx, o->x + o->w);
+        _screens_edge_add(si->ys, &si->ny, o->y);
+        _screens_edge_add(si->ys, &si->ny, o->y + o->h);
+    }
+
+    for (int j = 0; j < si->ny - 1; j++) {
+        for (int i = 0; i < si->nx - 1; i++) {
+            int cx = si->xs[i] + (si->xs[i + 1] - si->xs[i]) / 2;
+            int cy = si->ys[j] + (si->ys[j + 1] - si->ys[j]) / 2;
+            si->cells[j * (si->nx - 1) + i] = (unsigned char)_screens_nearest(si, cx, cy);
+        }
+    }
+}
+
+Eina_Bool
+screens_index_equal(const Screen_Index *a, const Screen_Index *b)
+{
+    if (a->count != b->count || a->has_workarea != b->has_workarea) return EINA_FALSE;
+    if (a->has_workarea && memcmp(&a->workarea, &b->workarea, sizeof(Screen_Output))) return EINA_FALSE;
+
+    for (int i = 0; i < a->count; i++) {
+        const Screen_Output *oa = &a->outputs[i], *ob = &b->outputs[i];
+        if (oa->x != ob->x || oa->y != ob->y || oa->w != ob->w || oa->h != ob->h ||
+            strcmp(oa->name, ob->name)) return EINA_FALSE;
+    }
+
+    return EINA_TRUE;
+}
+
+const Screen_Output *
+screens_index_lookup(const Screen_Index *si, int x, int y)
+{
+    int i = _screens_cell_find(si->xs, si->nx, x);
+    int j = _screens_cell_find(si->ys, si->ny, y);
+
+    return &si->outputs[si->cells[j * (si->nx - 1) + i]];
+}
+
+void
+screens_usable_get(const Screen_Index *si, const Screen_Output *o, Screen_Output *usable)
+{
+    *usable = *o;
+    if (!si->has_workarea) return;
+
+    const Screen_Output *wa = &si->workarea;
+    int x1 = o->x > wa->x ? o->x : wa->x;
+    int y1 = o->y > wa->y ? o->y : wa->y;
+    int x2 = (o->x + o->w) < (wa->x + wa->w) ? (o->x + o->w) : (wa->x + wa->w);
+    int y2 = (o->y + o->h) < (wa->y + wa->h) ? (o->y + o->h) : (wa->y + wa->h);
+
+    if (x2 <= x1 || y2 <= y1) return;
+
+    usable->x = x1;
+    usable->y = y1;
+    usable->w = x2 - x1;
+    usable->h = y2 - y1;
+}
+
+const Screen_Output *
+screens_index_find(const Screen_Index *si, const char *name)
+{
+    if (!name || !name[0]) return NULL;
+
+    for (int i = 0; i < si->count; i++) {
+        if (!strcmp(si->outputs[i].name, name)) return &si->outputs[i];
+    }
+
+    return NULL;
+}
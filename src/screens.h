@@ -0,0 +1,69 @@
+/**
+ * @file screens.h
+ * @brief Per-output screen geometry index
+ *
+ * Answers "which output contains this point, and what are its bounds"
+ * from a lookup grid built once per output layout, so drags and
+ * clamping never have to query the X server.
+ */
+
+#ifndef SCREENS_H
+#define SCREENS_H
+
+#include <Elementary.h>
+#include <Ecore_X.h>
+
+#include "screen_geometry.h"
+
+#define SCREEN_OUTPUTS_MAX 16
+#define SCREEN_EDGES_MAX   (SCREEN_OUTPUTS_MAX * 2)
+
+/**
+ * @brief Lookup grid over all outputs, plus the desktop work area
+ *
+ * The distinct output edges split the root window into cells; each cell
+ * maps to the output covering it, or to the nearest output for dead
+ * space between mismatched monitors.
+ */
+typedef struct _Screen_Index {
+    unsigned int version;           // Bumped by the owner whenever the model changes
+    Screen_Output outputs[SCREEN_OUTPUTS_MAX];
+    int count;
+    Screen_Output workarea;         // _NET_WORKAREA of the first desktop
+    Eina_Bool has_workarea;
+    int xs[SCREEN_EDGES_MAX];       // Sorted distinct vertical edges
+    int ys[SCREEN_EDGES_MAX];       // Sorted distinct horizontal edges
+    int nx, ny;
+    unsigned char cells[(SCREEN_EDGES_MAX - 1) * (SCREEN_EDGES_MAX - 1)];
+} Screen_Index;
+
+/**
+ * @brief Rebuilds the index from RandR, falling back to Xinerama
+ * @param fallback Geometry used as a single output if neither is available.
+ */
+void screens_index_build(Screen_Index *si, Ecore_X_Window root, const Screen_Output *fallback);
+
+/**
+ * @brief Whether two indexes describe the same outputs and work area
+ */
+Eina_Bool screens_index_equal(const Screen_Index *a, const Screen_Index *b);
+
+/**
+ * @brief Returns the output containing (x, y), or the nearest one
+ */
+const Screen_Output *screens_index_lookup(const Screen_Index *si, int x, int y);
+
+/**
+ * @brief Returns the part of output @p o not covered by panels and docks
+ *
+ * This is @p o intersected with the cached work area, or @p o itself
+ * when there is no work area or the two do not overlap.
+ */
+void screens_usable_get(const Screen_Index *si, const Screen_Output *o, Screen_Output *usable);
+
+/**
+ * @brief Returns the output called @p name, or NULL
+ */
+const Screen_Output *screens_index_find(const Screen_Index *si, const char *name);
+
+#endif /* SCREENS_H */
@@ -0,0 +1,52 @@
+/**
+ * @file tables.c
+ * @brief Lookup tables shared by the formatting code
+ */
+
+#include <locale.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "tables.h"
+#include "digits.h"
+
+const char tables_digits2[201] = TABLES_DIGITS2;
+
+static Tables_Locale _tables_locale;
+
+/**
+ * @brief Fills one name table through strftime()
+ */
+static void
+_tables_names_build(Tables_Name *names, Tables_Names table)
+{
+    static const char *specs[TABLES_NAMES_LAST] = { "%A", "%a", "%B", "%b", "%p" };
+    struct tm tm;
+
+    for (int i = 0; i < 12; i++) {
+        memset(&tm, 0, sizeof(tm));
+        tm.tm_year = 100;
+        tm.tm_wday = i % 7;
+        tm.tm_mon = i;
+        tm.tm_hour = i ? 12 : 0;
+        tm.tm_mday = 1;
+
+        names[i].len = (uint8_t)strftime(names[i].text, sizeof(names[i].text), specs[table], &tm);
+    }
+}
+
+const Tables_Locale *
+tables_locale_get(void)
+{
+    const char *locale = setlocale(LC_TIME, NULL);
+
+    if (!locale) locale = "C";
+    if (_tables_locale.locale[0] && !strcmp(_tables_locale.locale, locale))
+        return &_tables_locale;
+
+    for (int t = 0; t < TABLES_NAMES_LAST; t++)
+        _tables_names_build(_tables_locale.names[t], t);
+    snprintf(_tables_locale.locale, sizeof(_tables_locale.locale), "%s", locale);
+
+    return &_tables_locale;
+}
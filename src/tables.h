@@ -0,0 +1,65 @@
+/**
+ * @file tables.h
+ * @brief Lookup tables shared by the formatting code
+ *
+ * Localized weekday, month and AM/PM names with their lengths, built
+ * once through strftime() and rebuilt only when LC_TIME changes, and a
+ * 00-99 two-digit table generated at build time. Writing a field is
+ * then a memcpy() from one of these.
+ */
+
+#ifndef TABLES_H
+#define TABLES_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define TABLES_NAME_MAX     32      // Longest locale name kept, with its NUL
+
+typedef enum {
+    TABLES_NAMES_WDAY,      // %A, by tm_wday
+    TABLES_NAMES_WDAY_ABBR, // %a, by tm_wday
+    TABLES_NAMES_MON,       // %B, by tm_mon
+    TABLES_NAMES_MON_ABBR,  // %b, by tm_mon
+    TABLES_NAMES_AMPM,      // %p, 0 for AM and 1 for PM
+    TABLES_NAMES_LAST
+} Tables_Names;
+
+typedef struct _Tables_Name {
+    char text[TABLES_NAME_MAX];
+    uint8_t len;
+} Tables_Name;
+
+typedef struct _Tables_Locale {
+    char locale[64];                            // LC_TIME the names are for
+    Tables_Name names[TABLES_NAMES_LAST][12];
+} Tables_Locale;
+
+/**
+ * @brief "00" to "99", entry n at offset 2 * n
+ *
+ * One byte longer than the digits for the NUL of the literal it is
+ * initialized from; nothing relies on that NUL.
+ */
+extern const char tables_digits2[201];
+
+/**
+ * @brief Returns the name tables for the current LC_TIME
+ *
+ * Builds them on first use and again whenever LC_TIME has changed
+ * since, in place, so the returned pointer stays valid for the life
+ * of the process.
+ */
+const Tables_Locale *tables_locale_get(void);
+
+/**
+ * @brief Writes @p v (0-99) as two digits, the tens as @p pad when zero
+ */
+static inline void
+tables_num2_put(char *p, int v, char pad)
+{
+    memcpy(p, tables_digits2 + 2 * v, 2);
+    if (v < 10) p[0] = pad;
+}
+
+#endif /* TABLES_H */
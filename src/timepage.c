@@ -0,0 +1,181 @@
+/**
+ * @file timepage.c
+ * @brief Published time page - publisher and reader sides
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "timepage.h"
+
+#define TIMEPAGE_READ_RETRIES 1000 // An update takes well under a microsecond
+
+struct _Timepage_Reader {
+    const Timepage *page;
+};
+
+/**
+ * @brief Builds the current user's shm_open() name
+ */
+static void
+_timepage_name_get(char *name, size_t len)
+{
+    snprintf(name, len, TIMEPAGE_NAME_FMT, (unsigned)getuid());
+}
+
+Timepage *
+timepage_publisher_new(void)
+{
+    char name[64];
+    Timepage *tp;
+    int fd, err;
+
+    _timepage_name_get(name, sizeof(name));
+
+    fd = shm_open(name, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0) return NULL;
+
+    if (ftruncate(fd, sizeof(Timepage)) < 0) {
+        err = errno;
+        close(fd);
+        errno = err;
+        return NULL;
+    }
+
+    tp = mmap(NULL, sizeof(Timepage), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    err = errno;
+    close(fd);
+    if (tp == MAP_FAILED) {
+        errno = err;
+        return NULL;
+    }
+
+    // Left behind by a crashed clock, readers may still be looking at
+    // it; keep the sequence running rather than restarting it at zero
+    __atomic_store_n(&tp->seq, (__atomic_load_n(&tp->seq, __ATOMIC_RELAXED) + 1) | 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memset(&tp->data, 0, sizeof(tp->data));
+    tp->updates = 0;
+    tp->version = TIMEPAGE_VERSION;
+    tp->magic = TIMEPAGE_MAGIC;
+    __atomic_store_n(&tp->live, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&tp->seq, tp->seq + 1, __ATOMIC_RELEASE);
+
+    return tp;
+}
+
+void
+timepage_publish(Timepage *tp, const Timepage_Data *data)
+{
+    uint32_t seq = __atomic_load_n(&tp->seq, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&tp->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(&tp->data, data, sizeof(tp->data));
+    tp->updates++;
+    __atomic_store_n(&tp->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+void
+timepage_publisher_del(Timepage *tp)
+{
+    char name[64];
+
+    if (!tp) return;
+
+    __atomic_store_n(&tp->live, 0, __ATOMIC_RELEASE);
+    munmap(tp, sizeof(Timepage));
+
+    _timepage_name_get(name, sizeof(name));
+    shm_unlink(name);
+}
+
+Timepage_Reader *
+timepage_reader_open(void)
+{
+    Timepage_Reader *r;
+    struct stat st;
+    char name[64];
+    void *page;
+    int fd, err;
+
+    _timepage_name_get(name, sizeof(name));
+
+    fd = shm_open(name, O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) return NULL;
+
+    // A page being created may not have its final size yet
+    if (fstat(fd, &st) < 0) err = errno;
+    else if (st.st_size < (off_t)sizeof(Timepage)) err = EAGAIN;
+    else err = 0;
+    if (err) {
+        close(fd);
+        errno = err;
+        return NULL;
+    }
+
+    page = mmap(NULL, sizeof(Timepage), PROT_READ, MAP_SHARED, fd, 0);
+    err = errno;
+    close(fd);
+    if (page == MAP_FAILED) {
+        errno = err;
+        return NULL;
+    }
+
+    r = malloc(sizeof(Timepage_Reader));
+    if (!r) {
+        munmap(page, sizeof(Timepage));
+        errno = ENOMEM;
+        return NULL;
+    }
+    r->page = page;
+
+    return r;
+}
+
+void
+timepage_reader_close(Timepage_Reader *r)
+{
+    if (!r) return;
+
+    munmap((void *)r->page, sizeof(Timepage));
+    free(r);
+}
+
+int
+timepage_read(const Timepage_Reader *r, Timepage_Data *out)
+{
+    const Timepage *tp = r->page;
+    uint32_t seq;
+
+    for (int i = 0; i < TIMEPAGE_READ_RETRIES; i++) {
+        seq = __atomic_load_n(&tp->seq, __ATOMIC_ACQUIRE);
+        if (seq & 1) continue;
+
+        if (!__atomic_load_n(&tp->live, __ATOMIC_RELAXED) ||
+            tp->magic != TIMEPAGE_MAGIC || tp->version != TIMEPAGE_VERSION) {
+            errno = ESRCH;
+            return -1;
+        }
+
+        memcpy(out, &tp->data, sizeof(*out));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&tp->seq, __ATOMIC_RELAXED) == seq) {
+            // Guard callers against a torn or hostile page
+            out->mode[sizeof(out->mode) - 1] = '\0';
+            out->indicator[sizeof(out->indicator) - 1] = '\0';
+            out->time[sizeof(out->time) - 1] = '\0';
+            out->date[sizeof(out->date) - 1] = '\0';
+            return 0;
+        }
+    }
+
+    errno = EAGAIN;
+    return -1;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file timepage.h
+ * @brief Published time page - the clock's current display in shared memory
+ *
+ * With --publish-time the running clock keeps its first clock's time,
+ * date, mode and next-change deadline in a small POSIX shared-memory
+ * page. Other local programs map it read-only and take a consistent
+ * copy with timepage_read(), without syscalls or timers of their own.
+ *
+ * The page is guarded by a sequence lock: the publisher makes the
+ * sequence odd, updates the fields and makes it even again. A reader
+ * retries whenever it saw an odd sequence, or a different one after
+ * copying. Readers never block the clock.
+ *
+ * This header and timepage.c build the elive-clock-timepage library,
+ * which depends on nothing but libc.
+ */
+
+#ifndef TIMEPAGE_H
+#define TIMEPAGE_H
+
+#include <stdint.h>
+
+#define TIMEPAGE_NAME_FMT   "/elive-clock-time.%u"  // shm_open() name, per user id
+#define TIMEPAGE_MAGIC      0x4b434c45u             // "ELCK"
+#define TIMEPAGE_VERSION    1
+#define TIMEPAGE_TEXT_MAX   64
+
+/**
+ * @brief What the clock currently shows
+ *
+ * The text is what is on screen, NUL-terminated, and stays current
+ * until the deadline. A deadline well in the past means the clock
+ * stopped without removing the page.
+ */
+typedef struct _Timepage_Data {
+    int64_t updated_sec;            // CLOCK_REALTIME instant the text was computed for
+    int64_t updated_nsec;
+    int64_t deadline_sec;           // CLOCK_REALTIME instant the text next changes
+    int64_t deadline_nsec;
+    int32_t clock_mode;             // 0 local, 1 UTC, 2 Swatch
+    int32_t show_date;              // Whether the clock shows the date
+    char mode[16];                  // "local", "utc" or "swatch"
+    char indicator[32];             // Mode label, "" in local mode
+    char time[TIMEPAGE_TEXT_MAX];
+    char date[TIMEPAGE_TEXT_MAX];
+} Timepage_Data;
+
+/**
+ * @brief Layout of the shared page
+ */
+typedef struct _Timepage {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t seq;                   // Odd while an update is in progress
+    uint32_t live;                  // Cleared when the clock exits
+    uint64_t updates;               // Number of published updates
+    Timepage_Data data;
+} Timepage;
+
+/**
+ * @brief Reader-side handle on a mapped page
+ */
+typedef struct _Timepage_Reader Timepage_Reader;
+
+/**
+ * @brief Maps the current user's page read-only
+ * @return The reader, or NULL with errno set (ENOENT: no clock publishes)
+ */
+Timepage_Reader *timepage_reader_open(void);
+
+/**
+ * @brief Unmaps the page
+ */
+void timepage_reader_close(Timepage_Reader *r);
+
+/**
+ * @brief Takes a consistent copy of the published data
+ * @return 0 on success; -1 with errno ESRCH once the clock has exited,
+ *         or EAGAIN if every retry raced with an update
+ */
+int timepage_read(const Timepage_Reader *r, Timepage_Data *out);
+
+/**
+ * @brief Creates and maps the page read-write for publishing
+ * @return The page, or NULL with errno set
+ *
+ * Only one publisher may exist per user; the clock's instance lock
+ * guarantees that.
+ */
+Timepage *timepage_publisher_new(void);
+
+/**
+ * @brief Publishes new data
+ */
+void timepage_publish(Timepage *tp, const Timepage_Data *data);
+
+/**
+ * @brief Marks the page dead, unmaps and removes it
+ *
+ * Readers that still have it mapped see timepage_read() fail with ESRCH.
+ */
+void timepage_publisher_del(Timepage *tp);
+
+#endif /* TIMEPAGE_H */
@@ -0,0 +1,542 @@
+/**
+ * @file tz.c
+ * @brief Time zone engine on top of TZif files
+ *
+ * See RFC 8536 for the TZif format and POSIX for the TZ rule strings
+ * found in a TZif footer.
+ */
+
+#define _GNU_SOURCE
+#include <Eina.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+
+#include "tz.h"
+#include "civil.h"
+
+#define TZ_DIR_DEFAULT    "/usr/share/zoneinfo"
+#define TZ_LOCALTIME      "/etc/localtime"
+#define TZ_ABBR_MAX       16
+#define TZ_RULE_MAX       128     // Longest footer rule accepted
+#define TZIF_HEADER_SIZE  44
+#define TZIF_TYPES_MAX    256     // Type indexes are single bytes
+
+/**
+ * @brief One local time type of a TZif file
+ */
+typedef struct _Tz_Type {
+    int32_t utoff;
+    uint8_t isdst;
+    uint8_t abbr;       // Offset into the zone's abbreviation block
+} Tz_Type;
+
+/**
+ * @brief When a POSIX TZ rule switches, in local time
+ */
+typedef struct _Tz_Rule_Date {
+    char kind;          // 'J' (Julian 1-365, no Feb 29), 'D' (0-365) or 'M' (Mm.w.d)
+    int day;            // Day of year, or weekday (0 = Sunday) for 'M'
+    int week;           // 1-5, 5 meaning the last one of the month
+    int month;
+    int32_t time;       // Seconds after local midnight, may exceed a day
+} Tz_Rule_Date;
+
+/**
+ * @brief POSIX TZ rule, e.g. "CET-1CEST,M3.5.0,M10.5.0/3"
+ */
+typedef struct _Tz_Rule {
+    char std_abbr[TZ_ABBR_MAX];
+    char dst_abbr[TZ_ABBR_MAX];
+    int32_t std_utoff;
+    int32_t dst_utoff;
+    Eina_Bool has_dst;
+    Tz_Rule_Date start;     // Into daylight saving time
+    Tz_Rule_Date end;       // Back to standard time
+} Tz_Rule;
+
+struct _Tz_Zone {
+    const char *name;       // Lookup key (stringshare), "" for the local zone
+    int64_t *trans;         // Transition instants, ascending
+    uint8_t *trans_type;    // Type taking effect at each transition
+    int trans_count;
+    Tz_Type *types;         // types[0] also covers instants before trans[0]
+    int type_count;
+    char *abbrevs;          // NUL-separated abbreviations
+    Tz_Rule rule;           // Covers instants after the last transition
+    Eina_Bool has_rule;
+};
+
+/**
+ * @brief Counts from a TZif header
+ */
+typedef struct _Tzif_Counts {
+    uint32_t isut, isstd, leap, time, type, chars;
+} Tzif_Counts;
+
+static Eina_List *_zones = NULL;    // Tz_Zone cache
+
+static uint32_t
+_be32(const unsigned char *p)
+{
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+static int64_t
+_be64(const unsigned char *p)
+{
+    return (int64_t)((uint64_t)_be32(p) << 32 | _be32(p + 4));
+}
+
+/**
+ * @brief Reads a TZif header
+ * @return The format version, or 0 if @p p is not a TZif header
+ */
+static int
+_tzif_header_read(const unsigned char *p, size_t len, Tzif_Counts *c)
+{
+    if (len < TZIF_HEADER_SIZE || memcmp(p, "TZif", 4)) return 0;
+
+    c->isut = _be32(p + 20);
+    c->isstd = _be32(p + 24);
+    c->leap = _be32(p + 28);
+    c->time = _be32(p + 32);
+    c->type = _be32(p + 36);
+    c->chars = _be32(p + 40);
+
+    return p[4] ? p[4] - '0' : 1;
+}
+
+/**
+ * @brief Size of the data block following a header
+ * @param time_size 4 for the version 1 block, 8 for the later one.
+ */
+static uint64_t
+_tzif_data_size(const Tzif_Counts *c, int time_size)
+{
+    return (uint64_t)c->time * time_size + c->time + (uint64_t)c->type * 6 + c->chars +
+           (uint64_t)c->leap * (time_size + 4) + c->isstd + c->isut;
+}
+
+/**
+ * @brief Parses "[+-]hh[:mm[:ss]]"
+ */
+static const char *
+_tz_rule_time_parse(const char *s, int32_t *secs)
+{
+    int sign = 1, part[3] = { 0, 0, 0 };
+
+    if (*s == '+' || *s == '-') {
+        if (*s == '-') sign = -1;
+        s++;
+    }
+
+    for (int i = 0; i < 3; i++) {
+        if (i && *s++ != ':') {
+            s--;
+            break;
+        }
+        if (!isdigit((unsigned char)*s)) return NULL;
+        while (isdigit((unsigned char)*s) && part[i] < 1000) part[i] = part[i] * 10 + (*s++ - '0');
+    }
+    if (part[0] > 167 || part[1] > 59 || part[2] > 59) return NULL;
+
+    *secs = sign * (part[0] * 3600 + part[1] * 60 + part[2]);
+    return s;
+}
+
+/**
+ * @brief Parses a zone abbreviation, plain ("CET") or quoted ("<+0330>")
+ */
+static const char *
+_tz_rule_name_parse(const char *s, char *abbr)
+{
+    const char *start = s, *end;
+
+    if (*s == '<') {
+        start = ++s;
+        while (*s && *s != '>') s++;
+        if (*s != '>') return NULL;
+        end = s++;
+    } else {
+        while (isalpha((unsigned char)*s)) s++;
+        end = s;
+    }
+    if (end - start < 3 || end - start >= TZ_ABBR_MAX) return NULL;
+
+    memcpy(abbr, start, end - start);
+    abbr[end - start] = '\0';
+    return s;
+}
+
+/**
+ * @brief Parses a number within [@p min, @p max]
+ */
+static const char *
+_tz_rule_number_parse(const char *s, int min, int max, int *n)
+{
+    *n = 0;
+    if (!isdigit((unsigned char)*s)) return NULL;
+    while (isdigit((unsigned char)*s) && *n <= max) *n = *n * 10 + (*s++ - '0');
+
+    return *n >= min && *n <= max ? s : NULL;
+}
+
+/**
+ * @brief Parses "Jn", "n" or "Mm.w.d", with an optional "/time"
+ */
+static const char *
+_tz_rule_date_parse(const char *s, Tz_Rule_Date *d)
+{
+    memset(d, 0, sizeof(*d));
+
+    if (*s == 'M') {
+        d->kind = 'M';
+        if (!(s = _tz_rule_number_parse(s + 1, 1, 12, &d->month)) || *s++ != '.') return NULL;
+        if (!(s = _tz_rule_number_parse(s, 1, 5, &d->week)) || *s++ != '.') return NULL;
+        if (!(s = _tz_rule_number_parse(s, 0, 6, &d->day))) return NULL;
+    } else if (*s == 'J') {
+        d->kind = 'J';
+        if (!(s = _tz_rule_number_parse(s + 1, 1, 365, &d->day))) return NULL;
+    } else {
+        d->kind = 'D';
+        if (!(s = _tz_rule_number_parse(s, 0, 365, &d->day))) return NULL;
+    }
+
+    d->time = 2 * 3600;
+    if (*s == '/') s = _tz_rule_time_parse(s + 1, &d->time);
+
+    return s;
+}
+
+/**
+ * @brief Parses a POSIX TZ rule
+ */
+static Eina_Bool
+_tz_rule_parse(const char *s, Tz_Rule *r)
+{
+    int32_t off;
+
+    memset(r, 0, sizeof(*r));
+
+    // POSIX offsets count hours west of Greenwich
+    if (!(s = _tz_rule_name_parse(s, r->std_abbr))) return EINA_FALSE;
+    if (!(s = _tz_rule_time_parse(s, &off))) return EINA_FALSE;
+    r->std_utoff = -off;
+    if (!*s) return EINA_TRUE;
+
+    if (!(s = _tz_rule_name_parse(s, r->dst_abbr))) return EINA_FALSE;
+    r->has_dst = EINA_TRUE;
+    r->dst_utoff = r->std_utoff + 3600;
+    if (*s && *s != ',') {
+        if (!(s = _tz_rule_time_parse(s, &off))) return EINA_FALSE;
+        r->dst_utoff = -off;
+    }
+
+    // POSIX leaves a missing rule to the implementation; glibc uses the US one
+    if (!*s) s = ",M3.2.0,M11.1.0";
+
+    if (*s != ',' || !(s = _tz_rule_date_parse(s + 1, &r->start))) return EINA_FALSE;
+    if (*s != ',' || !(s = _tz_rule_date_parse(s + 1, &r->end))) return EINA_FALSE;
+
+    return !*s;
+}
+
+/**
+ * @brief Day number of a rule date in @p year
+ */
+static int64_t
+_tz_rule_date_days(int64_t year, const Tz_Rule_Date *d)
+{
+    Eina_Bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    int64_t first, limit;
+
+    switch (d->kind) {
+        case 'J':
+            return civil_days_from(year, 1, 1) + d->day - 1 + (leap && d->day >= 60);
+        case 'D':
+            return civil_days_from(year, 1, 1) + d->day;
+        default:
+            first = civil_days_from(year, d->month, 1);
+            limit = d->month == 12 ? civil_days_from(year + 1, 1, 1) : civil_days_from(year, d->month + 1, 1);
+            first += (d->day - (int)civil_weekday(first) + 7) % 7 + (d->week - 1) * 7;
+            while (first >= limit) first -= 7; // Week 5 means the last one
+            return first;
+    }
+}
+
+/**
+ * @brief Evaluates the zone's rule at @p t
+ *
+ * The switches of the surrounding years are enough to find both the
+ * one in effect and the next one, for rules in either hemisphere.
+ */
+static void
+_tz_rule_lookup(const Tz_Zone *z, int64_t t, Tz_Info *info)
+{
+    const Tz_Rule *r = &z->rule;
+    int64_t year, at, prev = INT64_MIN;
+    Eina_Bool isdst = EINA_FALSE;
+    unsigned m, d;
+
+    info->next = TZ_NEVER;
+
+    if (r->has_dst) {
+        civil_from_days(civil_days_of(t + r->std_utoff), &year, &m, &d);
+
+        for (int64_t y = year - 1; y <= year + 1; y++) {
+            // Daylight time starts by standard local time and ends by daylight local time
+            at = _tz_rule_date_days(y, &r->start) * 86400 + r->start.time - r->std_utoff;
+            if (at <= t && at > prev) {
+                prev = at;
+                isdst = EINA_TRUE;
+            } else if (at > t && at < info->next) {
+                info->next = at;
+            }
+
+            at = _tz_rule_date_days(y, &r->end) * 86400 + r->end.time - r->dst_utoff;
+            if (at <= t && at > prev) {
+                prev = at;
+                isdst = EINA_FALSE;
+            } else if (at > t && at < info->next) {
+                info->next = at;
+            }
+        }
+    }
+
+    info->isdst = isdst;
+    info->utoff = isdst ? r->dst_utoff : r->std_utoff;
+    info->abbrev = isdst ? r->dst_abbr : r->std_abbr;
+}
+
+void
+tz_lookup(const Tz_Zone *z, int64_t t, Tz_Info *info)
+{
+    const Tz_Type *type;
+    int lo = 0, hi = z->trans_count;
+
+    // Number of transitions at or before t
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+
+        if (z->trans[mid] <= t) lo = mid + 1;
+        else hi = mid;
+    }
+
+    if (lo == z->trans_count && z->has_rule) {
+        _tz_rule_lookup(z, t, info);
+        return;
+    }
+
+    type = &z->types[lo ? z->trans_type[lo - 1] : 0];
+    info->utoff = type->utoff;
+    info->isdst = type->isdst;
+    info->abbrev = z->abbrevs + type->abbr;
+    info->next = lo < z->trans_count ? z->trans[lo] : TZ_NEVER;
+}
+
+void
+tz_localtime(const Tz_Zone *z, time_t t, struct tm *tm, Tz_Info *info)
+{
+    tz_lookup(z, t, info);
+
+    civil_tm_get(t, info->utoff, tm);
+    tm->tm_isdst = info->isdst;
+    tm->tm_gmtoff = info->utoff;
+    tm->tm_zone = info->abbrev;
+}
+
+/**
+ * @brief Parses a mapped TZif file into @p z
+ *
+ * Version 2+ files carry the table twice; only the 64-bit copy and the
+ * footer rule after it are used. Leap second records are ignored.
+ */
+static Eina_Bool
+_tzif_parse(Tz_Zone *z, const unsigned char *p, size_t len)
+{
+    const unsigned char *d, *end;
+    Tzif_Counts c;
+    uint64_t size;
+    int version, time_size = 4;
+
+    version = _tzif_header_read(p, len, &c);
+    if (!version) return EINA_FALSE;
+    size = TZIF_HEADER_SIZE + _tzif_data_size(&c, 4);
+    if (size > len) return EINA_FALSE;
+
+    if (version >= 2) {
+        p += size;
+        len -= size;
+        if (!_tzif_header_read(p, len, &c)) return EINA_FALSE;
+        time_size = 8;
+        size = TZIF_HEADER_SIZE + _tzif_data_size(&c, 8);
+        if (size > len) return EINA_FALSE;
+    }
+    if (!c.type || c.type > TZIF_TYPES_MAX || !c.chars || c.time > INT_MAX) return EINA_FALSE;
+
+    z->trans = malloc((c.time ? c.time : 1) * sizeof(int64_t));
+    z->trans_type = malloc(c.time ? c.time : 1);
+    z->types = malloc(c.type * sizeof(Tz_Type));
+    z->abbrevs = malloc(c.chars + 1);
+    if (!z->trans || !z->trans_type || !z->types || !z->abbrevs) return EINA_FALSE;
+
+    d = p + TZIF_HEADER_SIZE;
+    for (uint32_t i = 0; i < c.time; i++, d += time_size)
+        z->trans[i] = time_size == 8 ? _be64(d) : (int32_t)_be32(d);
+    for (uint32_t i = 0; i < c.time; i++, d++) {
+        if (*d >= c.type) return EINA_FALSE;
+        z->trans_type[i] = *d;
+    }
+    for (uint32_t i = 0; i < c.type; i++, d += 6) {
+        z->types[i].utoff = (int32_t)_be32(d);
+        z->types[i].isdst = d[4];
+        z->types[i].abbr = d[5];
+        if (d[5] >= c.chars) return EINA_FALSE;
+    }
+    memcpy(z->abbrevs, d, c.chars);
+    z->abbrevs[c.chars] = '\0';
+    d += c.chars + (uint64_t)c.leap * (time_size + 4) + c.isstd + c.isut;
+
+    // Drop transitions that change nothing (zic emits some, e.g. one at
+    // the 32-bit limit), so that a lookup's next is always a real change
+    z->trans_count = 0;
+    for (uint32_t i = 0; i < c.time; i++) {
+        const Tz_Type *prev = &z->types[z->trans_count ? z->trans_type[z->trans_count - 1] : 0];
+        const Tz_Type *cur = &z->types[z->trans_type[i]];
+
+        if (cur->utoff == prev->utoff && cur->isdst == prev->isdst &&
+            !strcmp(z->abbrevs + cur->abbr, z->abbrevs + prev->abbr)) continue;
+        z->trans[z->trans_count] = z->trans[i];
+        z->trans_type[z->trans_count] = z->trans_type[i];
+        z->trans_count++;
+    }
+    z->type_count = (int)c.type;
+
+    // Footer: "\n<POSIX TZ rule>\n", the rule possibly empty
+    end = p + len;
+    if (version >= 2 && d < end && *d == '\n') {
+        const unsigned char *nl = memchr(d + 1, '\n', end - d - 1);
+        char rule[TZ_RULE_MAX];
+
+        if (nl && nl - d - 1 > 0 && nl - d - 1 < TZ_RULE_MAX) {
+            memcpy(rule, d + 1, nl - d - 1);
+            rule[nl - d - 1] = '\0';
+            z->has_rule = _tz_rule_parse(rule, &z->rule);
+        }
+    }
+
+    return EINA_TRUE;
+}
+
+/**
+ * @brief Maps a TZif file and parses it into @p z
+ */
+static Eina_Bool
+_tzif_load(Tz_Zone *z, const char *path)
+{
+    Eina_File *f;
+    void *map;
+    Eina_Bool ok = EINA_FALSE;
+
+    f = eina_file_open(path, EINA_FALSE);
+    if (!f) return EINA_FALSE;
+
+    map = eina_file_map_all(f, EINA_FILE_SEQUENTIAL);
+    if (map) {
+        ok = _tzif_parse(z, map, eina_file_size_get(f));
+        eina_file_map_free(f, map);
+    }
+    eina_file_close(f);
+
+    return ok;
+}
+
+/**
+ * @brief Releases a zone
+ */
+static void
+_tz_zone_free(Tz_Zone *z)
+{
+    eina_stringshare_del(z->name);
+    free(z->trans);
+    free(z->trans_type);
+    free(z->types);
+    free(z->abbrevs);
+    free(z);
+}
+
+/**
+ * @brief Loads a zone from its TZif file, or failing that as a POSIX rule
+ */
+static Tz_Zone *
+_tz_zone_load(const char *key)
+{
+    const char *spec = key, *dir;
+    char path[PATH_MAX];
+    Tz_Zone *z;
+
+    if (!*key) {
+        spec = getenv("TZ");
+        if (!spec) spec = TZ_LOCALTIME;
+        else if (*spec == ':') spec++;
+        if (!*spec) spec = "UTC0";
+    }
+
+    path[0] = '\0';
+    if (spec[0] == '/') {
+        snprintf(path, sizeof(path), "%s", spec);
+    } else if (!strstr(spec, "..")) {
+        dir = getenv("TZDIR");
+        if (!dir || !dir[0]) dir = TZ_DIR_DEFAULT;
+        snprintf(path, sizeof(path), "%s/%s", dir, spec);
+    }
+
+    z = calloc(1, sizeof(Tz_Zone));
+    if (!z) return NULL;
+
+    if (!path[0] || !_tzif_load(z, path)) {
+        // Not a zone file; maybe a rule such as "CET-1CEST,M3.5.0,M10.5.0/3"
+        free(z->trans);
+        free(z->trans_type);
+        free(z->types);
+        free(z->abbrevs);
+        memset(z, 0, sizeof(*z));
+        z->has_rule = _tz_rule_parse(spec, &z->rule);
+        if (!z->has_rule) {
+            free(z);
+            return NULL;
+        }
+    }
+
+    z->name = eina_stringshare_add(key);
+    return z;
+}
+
+const Tz_Zone *
+tz_zone_get(const char *name)
+{
+    const char *key = name ? name : "";
+    Tz_Zone *z;
+    Eina_List *l;
+
+    EINA_LIST_FOREACH(_zones, l, z) {
+        if (!strcmp(z->name, key)) return z;
+    }
+
+    z = _tz_zone_load(key);
+    if (z) _zones = eina_list_append(_zones, z);
+
+    return z;
+}
+
+void
+tz_shutdown(void)
+{
+    Tz_Zone *z;
+
+    EINA_LIST_FREE(_zones, z)
+        _tz_zone_free(z);
+}
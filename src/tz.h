@@ -0,0 +1,63 @@
+/**
+ * @file tz.h
+ * @brief Time zone engine on top of TZif files
+ *
+ * Zones are read from the system zoneinfo database (or $TZDIR) once,
+ * and their transition tables kept for the life of the process. An
+ * epoch-to-offset query is then a binary search over the table, with
+ * the file's POSIX TZ rule covering instants past its end. Nothing
+ * touches glibc's global time zone state, so any number of zones can
+ * be queried side by side without tzset() or setenv("TZ").
+ *
+ * Queries on a loaded zone are read-only and safe from any thread;
+ * tz_zone_get() and tz_shutdown() belong to the main loop.
+ */
+
+#ifndef TZ_H
+#define TZ_H
+
+#include <Eina.h>
+#include <stdint.h>
+#include <time.h>
+
+#define TZ_NEVER INT64_MAX    // No further transition is known
+
+typedef struct _Tz_Zone Tz_Zone;
+
+/**
+ * @brief Local time type in effect at an instant
+ */
+typedef struct _Tz_Info {
+    int32_t utoff;          // Seconds east of UTC
+    Eina_Bool isdst;
+    const char *abbrev;     // E.g. "CEST"; owned by the zone
+    int64_t next;           // First instant after the queried one with another type, or TZ_NEVER
+} Tz_Info;
+
+/**
+ * @brief Returns a zone, loading it on first use
+ * @param name Zone name such as "Europe/Paris", an absolute TZif path,
+ *        a POSIX TZ string, or NULL for the local zone ($TZ, else
+ *        /etc/localtime).
+ * @return The zone, valid until tz_shutdown(), or NULL if it cannot be read
+ */
+const Tz_Zone *tz_zone_get(const char *name);
+
+/**
+ * @brief Finds the local time type in effect at epoch second @p t
+ */
+void tz_lookup(const Tz_Zone *z, int64_t t, Tz_Info *info);
+
+/**
+ * @brief localtime_r() for an arbitrary zone
+ *
+ * Fills @p tm, including tm_gmtoff, tm_isdst and tm_zone, and @p info.
+ */
+void tz_localtime(const Tz_Zone *z, time_t t, struct tm *tm, Tz_Info *info);
+
+/**
+ * @brief Releases every loaded zone
+ */
+void tz_shutdown(void);
+
+#endif /* TZ_H */
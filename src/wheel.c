@@ -0,0 +1,196 @@
+/**
+ * @file wheel.c
+ * @brief Hierarchical timing wheel keyed by absolute deadlines
+ */
+
+#include <string.h>
+
+#include "wheel.h"
+
+#define WHEEL_SLOT_MASK     (WHEEL_SLOTS - 1)
+
+/**
+ * @brief Converts a deadline to wheel time
+ */
+static uint64_t
+_wheel_key(int64_t t)
+{
+    return t > 0 ? (uint64_t)t >> WHEEL_RES_SHIFT : 0;
+}
+
+/**
+ * @brief Pushes @p t onto a list
+ */
+static void
+_wheel_list_push(Wheel_Timer **head, Wheel_Timer *t)
+{
+    t->prev = NULL;
+    t->next = *head;
+    if (*head) (*head)->prev = t;
+    *head = t;
+}
+
+/**
+ * @brief Files a pending timer under the level and slot for its deadline
+ */
+static void
+_wheel_insert(Wheel *w, Wheel_Timer *t)
+{
+    uint64_t key = _wheel_key(t->deadline), diff;
+    int level = 0;
+
+    // Anything overdue goes with the current slot, which is fired first
+    if (key < w->clk) key = w->clk;
+
+    diff = key ^ w->clk;
+    if (diff) level = (63 - __builtin_clzll(diff)) / WHEEL_SLOT_BITS;
+
+    t->level = (uint8_t)level;
+    t->slot = (uint8_t)((key >> (level * WHEEL_SLOT_BITS)) & WHEEL_SLOT_MASK);
+    _wheel_list_push(&w->slots[level][t->slot], t);
+    w->occupied[level] |= 1ULL << t->slot;
+}
+
+/**
+ * @brief Unlinks @p t from its slot or from the due list
+ */
+static void
+_wheel_unlink(Wheel *w, Wheel_Timer *t)
+{
+    Wheel_Timer **head = t->level < WHEEL_LEVELS ? &w->slots[t->level][t->slot] : &w->due;
+
+    if (t->prev) t->prev->next = t->next;
+    else *head = t->next;
+    if (t->next) t->next->prev = t->prev;
+
+    if (t->level < WHEEL_LEVELS && !*head) w->occupied[t->level] &= ~(1ULL << t->slot);
+    t->next = t->prev = NULL;
+}
+
+/**
+ * @brief Moves every timer in the slots of @p level set in @p mask onto @p list
+ */
+static void
+_wheel_detach(Wheel *w, int level, uint64_t mask, Wheel_Timer **list)
+{
+    uint64_t bits = w->occupied[level] & mask;
+
+    while (bits) {
+        int slot = __builtin_ctzll(bits);
+        Wheel_Timer *t = w->slots[level][slot], *next;
+
+        bits &= bits - 1;
+        for (; t; t = next) {
+            next = t->next;
+            _wheel_list_push(list, t);
+        }
+        w->slots[level][slot] = NULL;
+        w->occupied[level] &= ~(1ULL << slot);
+    }
+}
+
+void
+wheel_init(Wheel *w, int64_t now)
+{
+    memset(w, 0, sizeof(*w));
+    w->clk = _wheel_key(now);
+}
+
+void
+wheel_timer_init(Wheel_Timer *t, Wheel_Cb cb, const void *data)
+{
+    memset(t, 0, sizeof(*t));
+    t->cb = cb;
+    t->data = (void *)data;
+}
+
+void
+wheel_timer_add(Wheel *w, Wheel_Timer *t, int64_t deadline)
+{
+    if (t->pending) _wheel_unlink(w, t);
+    else w->count++;
+
+    t->pending = EINA_TRUE;
+    t->deadline = deadline;
+    _wheel_insert(w, t);
+}
+
+void
+wheel_timer_cancel(Wheel *w, Wheel_Timer *t)
+{
+    if (!t->pending) return;
+
+    _wheel_unlink(w, t);
+    t->pending = EINA_FALSE;
+    w->count--;
+}
+
+Eina_Bool
+wheel_next(const Wheel *w, int64_t *deadline)
+{
+    // The lowest non-empty level holds the earliest timers, and within
+    // it the first slot from the current one; only that slot is scanned
+    for (int level = 0; level < WHEEL_LEVELS; level++) {
+        int cur = (w->clk >> (level * WHEEL_SLOT_BITS)) & WHEEL_SLOT_MASK;
+        uint64_t bits = w->occupied[level] & (~0ULL << cur);
+        const Wheel_Timer *t;
+
+        if (!bits) continue;
+
+        t = w->slots[level][__builtin_ctzll(bits)];
+        *deadline = t->deadline;
+        for (t = t->next; t; t = t->next) {
+            if (t->deadline < *deadline) *deadline = t->deadline;
+        }
+        return EINA_TRUE;
+    }
+
+    return EINA_FALSE;
+}
+
+unsigned int
+wheel_advance(Wheel *w, int64_t now)
+{
+    uint64_t old = w->clk, clk = _wheel_key(now);
+    Wheel_Timer *moved = NULL, *t, *next;
+    unsigned int fired = 0;
+
+    // Collect every timer whose slot the new time has reached; all others
+    // stay valid. Going backwards invalidates the whole layout.
+    for (int level = 0; level < WHEEL_LEVELS; level++) {
+        int shift = level * WHEEL_SLOT_BITS;
+        int from = (old >> shift) & WHEEL_SLOT_MASK;
+        int to = (clk >> shift) & WHEEL_SLOT_MASK;
+
+        if (clk < old || (old >> shift >> WHEEL_SLOT_BITS) != (clk >> shift >> WHEEL_SLOT_BITS)) {
+            _wheel_detach(w, level, ~0ULL, &moved);
+        } else {
+            // Slots from..to inclusive
+            uint64_t mask = (to == WHEEL_SLOT_MASK ? ~0ULL : (1ULL << (to + 1)) - 1) & (~0ULL << from);
+
+            _wheel_detach(w, level, mask, &moved);
+        }
+    }
+    w->clk = clk;
+
+    for (t = moved; t; t = next) {
+        next = t->next;
+        if (t->deadline <= now) {
+            t->level = WHEEL_LEVELS;
+            _wheel_list_push(&w->due, t);
+        } else {
+            _wheel_insert(w, t);
+        }
+    }
+
+    // A callback may cancel or re-add any timer still on the due list
+    while ((t = w->due)) {
+        _wheel_unlink(w, t);
+        t->pending = EINA_FALSE;
+        w->count--;
+        fired++;
+        t->cb(t->data, now);
+    }
+
+    return fired;
+}
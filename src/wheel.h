@@ -0,0 +1,96 @@
+/**
+ * @file wheel.h
+ * @brief Hierarchical timing wheel keyed by absolute deadlines
+ *
+ * Timers are kept in WHEEL_LEVELS levels of WHEEL_SLOTS slots, each
+ * level 64 times coarser than the one below. A timer sits on the level
+ * of the highest WHEEL_SLOT_BITS-bit group in which its deadline
+ * differs from the wheel's current time, so every timer on a lower
+ * level is due before any timer on a higher one. Adding and cancelling
+ * are O(1), and finding the earliest deadline looks at one slot.
+ *
+ * The wheel never reads a clock: time only moves through
+ * wheel_advance(), which fires everything due in one pass. The caller
+ * arms a single OS timer for wheel_next() and advances the wheel when
+ * it fires.
+ */
+
+#ifndef WHEEL_H
+#define WHEEL_H
+
+#include <Eina.h>
+#include <stdint.h>
+
+#define WHEEL_RES_SHIFT     20      // Slot width at level 0: 2^20 ns, about 1 ms
+#define WHEEL_SLOT_BITS     6
+#define WHEEL_SLOTS         (1 << WHEEL_SLOT_BITS)
+#define WHEEL_LEVELS        8       // Covers 2^68 ns, past any int64_t deadline
+
+/**
+ * @brief Called once a timer's deadline has been reached
+ * @param now The time the wheel was advanced to, in nanoseconds.
+ */
+typedef void (*Wheel_Cb)(void *data, int64_t now);
+
+/**
+ * @brief A timer, embedded by its owner; not pending until added
+ */
+typedef struct _Wheel_Timer {
+    struct _Wheel_Timer *next;
+    struct _Wheel_Timer *prev;
+    int64_t deadline;       // Absolute, in nanoseconds
+    Wheel_Cb cb;
+    void *data;
+    uint8_t level;          // Slot it sits in, or WHEEL_LEVELS when due
+    uint8_t slot;
+    Eina_Bool pending;
+} Wheel_Timer;
+
+typedef struct _Wheel {
+    uint64_t clk;                                   // Current time, in level-0 slots
+    uint64_t occupied[WHEEL_LEVELS];                // Bit per non-empty slot
+    Wheel_Timer *slots[WHEEL_LEVELS][WHEEL_SLOTS];
+    Wheel_Timer *due;                               // Being fired by wheel_advance()
+    unsigned int count;                             // Pending timers
+} Wheel;
+
+/**
+ * @brief Initializes an empty wheel whose current time is @p now
+ */
+void wheel_init(Wheel *w, int64_t now);
+
+/**
+ * @brief Initializes a timer that is not pending
+ */
+void wheel_timer_init(Wheel_Timer *t, Wheel_Cb cb, const void *data);
+
+/**
+ * @brief Makes @p t fire at @p deadline, replacing any deadline it had
+ *
+ * A deadline at or before the current time fires on the next advance.
+ */
+void wheel_timer_add(Wheel *w, Wheel_Timer *t, int64_t deadline);
+
+/**
+ * @brief Stops @p t from firing; does nothing if it is not pending
+ */
+void wheel_timer_cancel(Wheel *w, Wheel_Timer *t);
+
+/**
+ * @brief Returns the earliest pending deadline in @p deadline
+ * @return EINA_FALSE if no timer is pending
+ */
+Eina_Bool wheel_next(const Wheel *w, int64_t *deadline);
+
+/**
+ * @brief Moves the wheel to @p now and fires every timer due by then
+ * @return The number of timers fired
+ *
+ * Timers fire in no particular order. Callbacks may add and cancel any
+ * timer, including their own; one added for a deadline already passed
+ * waits for the next advance. Moving backwards, after the clock was
+ * stepped, re-sorts every timer.
+ */
+unsigned int wheel_advance(Wheel *w, int64_t now);
+
+#endif /* WHEEL_H */
@@ -0,0 +1,103 @@
+/**
+ * @file bench_civil.c
+ * @brief Batch civil conversion against gmtime_r(), for 1k and 100k instants
+ *
+ * Each instant is checked against gmtime_r() before timing, so a fast
+ * wrong answer fails the benchmark.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "civil_batch.h"
+
+#define BENCH_WORK 10000000     // Conversions per measurement
+
+static double
+_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int
+_check(const Civil_Batch *b)
+{
+    for (int i = 0; i < b->count; i++) {
+        time_t t = b->epoch[i] + b->utoff[i];
+        struct tm tm;
+
+        gmtime_r(&t, &tm);
+        if (b->year[i] != tm.tm_year + 1900 || b->month[i] != tm.tm_mon + 1 ||
+            b->day[i] != tm.tm_mday || b->yday[i] != tm.tm_yday || b->wday[i] != tm.tm_wday ||
+            b->hour[i] != tm.tm_hour || b->min[i] != tm.tm_min || b->sec[i] != tm.tm_sec) {
+            fprintf(stderr, "Mismatch at %lld%+d\n", (long long)b->epoch[i], b->utoff[i]);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int
+_bench(int count)
+{
+    Civil_Batch *b = civil_batch_new(count);
+    int rounds = BENCH_WORK / count;
+    volatile int sink = 0;
+    double start, batch, gm;
+
+    if (!b) return -1;
+
+    // Instants spread over 1900-2100, with offsets of whole quarter hours
+    srand(count);
+    b->count = count;
+    for (int i = 0; i < count; i++) {
+        b->epoch[i] = (int64_t)(rand() % 200 - 70) * 31556952 + rand() % 31556952;
+        b->utoff[i] = (rand() % 105 - 48) * 900;
+    }
+
+    civil_batch_convert(b);
+    if (_check(b) < 0) {
+        civil_batch_free(b);
+        return -1;
+    }
+
+    start = _now();
+    for (int r = 0; r < rounds; r++) {
+        civil_batch_convert(b);
+        sink += b->sec[r % count];
+    }
+    batch = _now() - start;
+
+    start = _now();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < count; i++) {
+            time_t t = b->epoch[i] + b->utoff[i];
+            struct tm tm;
+
+            gmtime_r(&t, &tm);
+            sink += tm.tm_sec;
+        }
+    }
+    gm = _now() - start;
+
+    printf("%6d instants: batch %6.2f ns, gmtime_r %6.2f ns per conversion (%.1fx)\n",
+           count, batch * 1e9 / ((double)rounds * count), gm * 1e9 / ((double)rounds * count),
+           gm / batch);
+
+    civil_batch_free(b);
+    return 0;
+}
+
+int
+main(void)
+{
+    if (_bench(1000) < 0 || _bench(100000) < 0) return 1;
+
+    return 0;
+}
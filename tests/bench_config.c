@@ -0,0 +1,113 @@
+/**
+ * @file bench_config.c
+ * @brief Config save cost, per-call descriptors against the persistent store
+ *
+ * "fresh" rebuilds the descriptors and reopens the file around every
+ * save, as the gadget did before it kept a Config_Store. "store" keeps
+ * them for the whole run and remaps after each write. "unchanged" is a
+ * flush with nothing new, which the store answers without touching the
+ * disk.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <limits.h>
+#include <Eina.h>
+#include <Eet.h>
+
+#include "config.h"
+
+#define BENCH_CLOCKS 4
+#define BENCH_ROUNDS 500
+
+static double
+_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void
+_report(const char *what, double start)
+{
+    printf("%-18s %8.2f us/op\n", what, (_now() - start) * 1e6 / BENCH_ROUNDS);
+}
+
+int
+main(void)
+{
+    char dir[] = "/tmp/clock-bench-XXXXXX";
+    char path[PATH_MAX];
+    Config config = { 0 };
+    Config_Store cs;
+    Config *loaded;
+    double start;
+    int i;
+
+    if (!mkdtemp(dir)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    snprintf(path, sizeof(path), "%s/config.eet", dir);
+
+    eina_init();
+    eet_init();
+
+    for (i = 0; i < BENCH_CLOCKS; i++) {
+        Config_Clock *cc = config_clock_new(&config);
+
+        cc->output = eina_stringshare_add("HDMI-1");
+        cc->time_format = eina_stringshare_add("%H:%M:%S");
+    }
+
+    start = _now();
+    for (i = 0; i < BENCH_ROUNDS; i++) {
+        config_store_init(&cs);
+        config_store_map(&cs, path);
+        if (!config_write(path, cs.edd, &config)) return 1;
+        config_store_close(&cs);
+        config_store_descriptors_free(&cs);
+    }
+    _report("save fresh", start);
+
+    config_store_init(&cs);
+    start = _now();
+    for (i = 0; i < BENCH_ROUNDS; i++) {
+        if (!config_write(path, cs.edd, &config)) return 1;
+        config_store_written_set(&cs, &config);
+        config_store_map(&cs, path);
+    }
+    _report("save store", start);
+
+    start = _now();
+    for (i = 0; i < BENCH_ROUNDS; i++) {
+        if (!config_store_unchanged(&cs, &config)) return 1;
+    }
+    _report("save unchanged", start);
+
+    start = _now();
+    for (i = 0; i < BENCH_ROUNDS; i++) {
+        loaded = config_store_load(&cs);
+        if (!loaded || eina_list_count(loaded->clocks) != BENCH_CLOCKS) return 1;
+        config_clear(loaded);
+        free(loaded);
+    }
+    _report("load mapped", start);
+
+    config_store_close(&cs);
+    config_store_descriptors_free(&cs);
+    config_clear(&config);
+
+    unlink(path);
+    rmdir(dir);
+
+    eet_shutdown();
+    eina_shutdown();
+
+    return 0;
+}
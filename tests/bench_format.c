@@ -0,0 +1,67 @@
+/**
+ * @file bench_format.c
+ * @brief Compiled formats against strftime(), per call
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <locale.h>
+#include <time.h>
+
+#include "format.h"
+
+#define BENCH_CALLS 1000000
+
+static const char *_formats[] = {
+    "%H:%M", "%H:%M:%S", "%I:%M %p", "%A, %d %B %Y", "%a %e %b", "%T", "%c",
+};
+
+static double
+_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int
+main(void)
+{
+    time_t t = 1704067200;  // 2024-01-01 00:00:00 UTC
+    struct tm tm;
+    char buf[128];
+    volatile size_t sink = 0;
+
+    setlocale(LC_ALL, "");
+    gmtime_r(&t, &tm);
+
+    for (size_t i = 0; i < sizeof(_formats) / sizeof(_formats[0]); i++) {
+        Format f;
+        double start, compiled, ref;
+
+        if (!format_compile(&f, _formats[i])) return 1;
+
+        // Vary the fields so neither side sees one instant only
+        start = _now();
+        for (int n = 0; n < BENCH_CALLS; n++) {
+            tm.tm_sec = n % 60;
+            tm.tm_min = n / 60 % 60;
+            sink += format_exec(&f, &tm, buf, sizeof(buf));
+        }
+        compiled = _now() - start;
+
+        start = _now();
+        for (int n = 0; n < BENCH_CALLS; n++) {
+            tm.tm_sec = n % 60;
+            tm.tm_min = n / 60 % 60;
+            sink += strftime(buf, sizeof(buf), _formats[i], &tm);
+        }
+        ref = _now() - start;
+
+        printf("%-14s compiled %6.1f ns, strftime %6.1f ns (%.1fx)\n", _formats[i],
+               compiled * 1e9 / BENCH_CALLS, ref * 1e9 / BENCH_CALLS, ref / compiled);
+    }
+
+    return 0;
+}
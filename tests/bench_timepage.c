@@ -0,0 +1,134 @@
+/**
+ * @file bench_timepage.c
+ * @brief Time page read throughput, one writer against N readers
+ *
+ * The writer publishes as fast as it can, far more often than the
+ * clock ever does, so readers keep racing with updates. Every copy a
+ * reader gets is checked for tearing: the writer keeps the time text
+ * in step with updated_sec.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "timepage.h"
+
+#define BENCH_SECONDS       1
+#define BENCH_READERS_MAX   8
+
+typedef struct _Reader_Stats {
+    pthread_t thread;
+    unsigned long reads;
+    unsigned long busy;     // EAGAIN, every retry raced with the writer
+    unsigned long torn;     // Inconsistent copies, must stay 0
+} Reader_Stats;
+
+static int running;
+
+static void *
+_writer_run(void *data)
+{
+    Timepage *tp = data;
+    Timepage_Data d;
+    int64_t i = 0;
+
+    memset(&d, 0, sizeof(d));
+    strcpy(d.mode, "local");
+    while (__atomic_load_n(&running, __ATOMIC_RELAXED)) {
+        d.updated_sec = d.deadline_sec = i++;
+        snprintf(d.time, sizeof(d.time), "%lld", (long long)d.updated_sec);
+        timepage_publish(tp, &d);
+    }
+
+    return NULL;
+}
+
+static void *
+_reader_run(void *data)
+{
+    Reader_Stats *rs = data;
+    Timepage_Reader *r = timepage_reader_open();
+    Timepage_Data d;
+    char expect[TIMEPAGE_TEXT_MAX];
+
+    if (!r) return NULL;
+
+    while (__atomic_load_n(&running, __ATOMIC_RELAXED)) {
+        if (timepage_read(r, &d) < 0) {
+            rs->busy++;
+            continue;
+        }
+        snprintf(expect, sizeof(expect), "%lld", (long long)d.updated_sec);
+        if (d.deadline_sec != d.updated_sec || strcmp(d.time, expect)) rs->torn++;
+        rs->reads++;
+    }
+
+    timepage_reader_close(r);
+    return NULL;
+}
+
+int
+main(void)
+{
+    Timepage_Reader *live;
+    Timepage_Data d;
+    Timepage *tp;
+    unsigned long torn = 0;
+
+    // Do not take over the page of a clock running for this user
+    live = timepage_reader_open();
+    if (live) {
+        int busy = timepage_read(live, &d) == 0;
+
+        timepage_reader_close(live);
+        if (busy) {
+            fprintf(stderr, "A clock is publishing its time; skipping\n");
+            return 77;
+        }
+    }
+
+    tp = timepage_publisher_new();
+    if (!tp) {
+        perror("timepage_publisher_new");
+        return 1;
+    }
+
+    for (int n = 1; n <= BENCH_READERS_MAX; n *= 2) {
+        Reader_Stats rs[BENCH_READERS_MAX];
+        pthread_t writer;
+        unsigned long reads = 0, busy = 0;
+        uint64_t updates = tp->updates;
+
+        memset(rs, 0, sizeof(rs));
+        __atomic_store_n(&running, 1, __ATOMIC_RELAXED);
+        pthread_create(&writer, NULL, _writer_run, tp);
+        for (int i = 0; i < n; i++) pthread_create(&rs[i].thread, NULL, _reader_run, &rs[i]);
+
+        nanosleep(&(struct timespec){ BENCH_SECONDS, 0 }, NULL);
+
+        __atomic_store_n(&running, 0, __ATOMIC_RELAXED);
+        pthread_join(writer, NULL);
+        for (int i = 0; i < n; i++) {
+            pthread_join(rs[i].thread, NULL);
+            reads += rs[i].reads;
+            busy += rs[i].busy;
+            torn += rs[i].torn;
+        }
+
+        printf("%d reader(s): %10.0f reads/s per reader, %lu busy, %lu updates\n",
+               n, (double)reads / n / BENCH_SECONDS, busy, (unsigned long)(tp->updates - updates));
+    }
+
+    timepage_publisher_del(tp);
+
+    if (torn) {
+        fprintf(stderr, "%lu torn reads\n", torn);
+        return 1;
+    }
+
+    return 0;
+}
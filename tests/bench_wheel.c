@@ -0,0 +1,75 @@
+/**
+ * @file bench_wheel.c
+ * @brief Timing wheel cost per operation with 10k pending deadlines
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "wheel.h"
+
+#define BENCH_TIMERS    10000
+#define BENCH_SEC       1000000000LL
+
+static Wheel_Timer _timers[BENCH_TIMERS];
+static Wheel _wheel;
+
+static double
+_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void
+_report(const char *what, double start, unsigned long ops)
+{
+    printf("%-24s %7.1f ns/op\n", what, (_now() - start) * 1e9 / ops);
+}
+
+/**
+ * @brief Re-arms for the next second, as a clock showing seconds does
+ */
+static void
+_rearm_cb(void *data, int64_t now)
+{
+    wheel_timer_add(&_wheel, data, now - now % BENCH_SEC + BENCH_SEC);
+}
+
+int
+main(void)
+{
+    int64_t now = 1700000000LL * BENCH_SEC, deadline = 0;
+    unsigned long fired = 0;
+    double start;
+
+    srand(1);
+    wheel_init(&_wheel, now);
+    for (int i = 0; i < BENCH_TIMERS; i++)
+        wheel_timer_init(&_timers[i], _rearm_cb, &_timers[i]);
+
+    // Spread over the next hour
+    start = _now();
+    for (int i = 0; i < BENCH_TIMERS; i++)
+        wheel_timer_add(&_wheel, &_timers[i], now + 1 + (((int64_t)rand() << 31) ^ rand()) % (3600 * BENCH_SEC));
+    _report("add", start, BENCH_TIMERS);
+
+    start = _now();
+    for (int i = 0; i < BENCH_TIMERS; i++) wheel_next(&_wheel, &deadline);
+    _report("next", start, BENCH_TIMERS);
+
+    // Fire and re-arm every timer for an hour of ticks
+    start = _now();
+    while (wheel_next(&_wheel, &deadline) && deadline < now + 3600 * BENCH_SEC)
+        fired += wheel_advance(&_wheel, deadline);
+    _report("advance, per fired timer", start, fired);
+
+    start = _now();
+    for (int i = 0; i < BENCH_TIMERS; i++) wheel_timer_cancel(&_wheel, &_timers[i]);
+    _report("cancel", start, BENCH_TIMERS);
+
+    return _wheel.count != 0;
+}
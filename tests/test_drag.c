@@ -0,0 +1,110 @@
+/**
+ * @file test_drag.c
+ * @brief Drag threshold, backend choice, bounds, snapping and clamping
+ */
+
+#include <stdio.h>
+
+#include "drag.h"
+
+static int failures;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    } \
+} while (0)
+
+static void
+_test_threshold(void)
+{
+    CHECK(!drag_threshold_crossed(0, 0));
+    CHECK(!drag_threshold_crossed(5, 0));
+    CHECK(!drag_threshold_crossed(0, -5));
+    CHECK(!drag_threshold_crossed(3, 4));   // Exactly 5 px away
+    CHECK(drag_threshold_crossed(6, 0));
+    CHECK(drag_threshold_crossed(-4, 4));
+}
+
+static void
+_test_backend(void)
+{
+    CHECK(!drag_wm_wanted(0, 1));
+    CHECK(drag_wm_wanted(1, 1));
+    CHECK(drag_wm_wanted(0, 0));  // Wayland
+    CHECK(drag_wm_wanted(1, 0));
+}
+
+static void
+_test_bounds(void)
+{
+    Screen_Output o = { 0, 0, 1920, 1080, "HDMI-1" };
+    Screen_Output panel = { 0, 0, 1920, 1040, "HDMI-1" };    // 40 px panel at the bottom
+    Screen_Output right = { 1920, 0, 1280, 1024, "DP-1" };
+    Drag_Bounds b;
+
+    // Bare edges everywhere: 30% of 200x100 may hang off each side
+    drag_bounds_get(&o, &o, 200, 100, &b);
+    CHECK(b.min_x == -60 && b.max_x == 1920 - 200 + 60);
+    CHECK(b.min_y == -30 && b.max_y == 1080 - 100 + 30);
+
+    // The panel edge allows no overhang
+    drag_bounds_get(&o, &panel, 200, 100, &b);
+    CHECK(b.min_y == -30 && b.max_y == 1040 - 100);
+
+    // Outputs not at the origin
+    drag_bounds_get(&right, &right, 200, 100, &b);
+    CHECK(b.min_x == 1920 - 60 && b.max_x == 1920 + 1280 - 200 + 60);
+
+    // Larger than the work area: pinned to its top-left
+    drag_bounds_get(&o, &panel, 6000, 2000, &b);
+    CHECK(b.min_x == -1800 && b.max_x == b.min_x);
+    CHECK(b.min_y == -600 && b.max_y == b.min_y);
+}
+
+static void
+_test_snap_clamp(void)
+{
+    Screen_Output o = { 0, 0, 1920, 1080, "HDMI-1" };
+    Screen_Output panel = { 0, 0, 1920, 1040, "HDMI-1" };
+    Drag_Bounds b;
+    int x, y;
+
+    // Near the top-left corner: both axes snap
+    x = 7; y = -9;
+    drag_snap(&o, 10, 200, 100, &x, &y);
+    CHECK(x == 0 && y == 0);
+
+    // Near the panel: snaps onto it, not onto the bare bottom edge
+    x = 500; y = 1040 - 100 + 8;
+    drag_snap(&panel, 10, 200, 100, &x, &y);
+    CHECK(x == 500 && y == 940);
+
+    // Out of reach, or snapping disabled
+    x = 11; y = 500;
+    drag_snap(&o, 10, 200, 100, &x, &y);
+    CHECK(x == 11 && y == 500);
+    x = 3; y = 3;
+    drag_snap(&o, 0, 200, 100, &x, &y);
+    CHECK(x == 3 && y == 3);
+
+    drag_bounds_get(&o, &panel, 200, 100, &b);
+    x = -500; y = 5000;
+    drag_clamp(&b, &x, &y);
+    CHECK(x == -60 && y == 940);
+    x = 100; y = 100;
+    drag_clamp(&b, &x, &y);
+    CHECK(x == 100 && y == 100);
+}
+
+int
+main(void)
+{
+    _test_threshold();
+    _test_backend();
+    _test_bounds();
+    _test_snap_clamp();
+
+    return failures ? 1 : 0;
+}
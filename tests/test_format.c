@@ -0,0 +1,135 @@
+/**
+ * @file test_format.c
+ * @brief Compiled formats against strftime(), for every second of a year
+ *
+ * strftime() is only asked again when a format's resolution says its
+ * output may have changed; every second in between must give the same
+ * text, which also checks the resolution the tick scheduling relies on.
+ *
+ * Output cut short by a small buffer is checked at a few times per
+ * month: it must stay a prefix of the full text.
+ *
+ * Takes an optional month (1-12) to check only that month of the year,
+ * so the runs can go in parallel.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include <time.h>
+
+#include "format.h"
+
+#define TEST_YEAR 2024              // A leap year
+
+static const char *_formats[] = {
+    "%H:%M:%S", "%H:%M", "%A, %B %d, %Y",  // The gadget's defaults
+    "%I:%M %p", "%a %d %b %Y", "%e", "%y", "%m", "%h", "%A", "%B", "%R", "%T",
+    "%D", "%F", "%l", "%k", "%j", "%c",
+};
+
+#define FORMATS_COUNT (int)(sizeof(_formats) / sizeof(_formats[0]))
+
+/**
+ * @brief Every buffer size short of the full text must give a prefix of it
+ */
+static int
+_test_truncation(const char *locale, const Format *f, const char *fmt, const struct tm *tm)
+{
+    char full[128], out[128];
+    size_t full_len, n;
+    int failures = 0;
+
+    full_len = format_exec(f, tm, full, sizeof(full));
+
+    for (size_t len = 1; len <= full_len + 1; len++) {
+        memset(out, 'X', sizeof(out));
+        n = format_exec(f, tm, out, len);
+        if (n != strlen(out) || n >= len || strncmp(out, full, n) || out[len] != 'X') {
+            if (failures++ < 10)
+                fprintf(stderr, "%s: \"%s\" into %zu bytes: \"%s\" (%zu), full text \"%s\"\n",
+                        locale, fmt, len, out, n, full);
+        }
+    }
+
+    return failures;
+}
+
+static int
+_test_locale(const char *locale, time_t start, time_t end)
+{
+    Format f[FORMATS_COUNT];
+    char out[128], ref[FORMATS_COUNT][128];
+    int failures = 0;
+
+    if (!setlocale(LC_ALL, locale)) {
+        fprintf(stderr, "Locale %s not available, skipped\n", locale);
+        return 0;
+    }
+
+    for (int i = 0; i < FORMATS_COUNT; i++) {
+        if (!format_compile(&f[i], _formats[i])) {
+            fprintf(stderr, "%s: could not compile \"%s\"\n", locale, _formats[i]);
+            return 1;
+        }
+        for (time_t t = start; t < end; t += 86400 * 7 + 3600 * 13 + 60 * 7 + 11) {
+            struct tm tm;
+
+            gmtime_r(&t, &tm);
+            failures += _test_truncation(locale, &f[i], _formats[i], &tm);
+        }
+    }
+
+    for (time_t t = start; t < end; t++) {
+        struct tm tm;
+
+        gmtime_r(&t, &tm);
+        for (int i = 0; i < FORMATS_COUNT; i++) {
+            if (t == start || t % f[i].resolution == 0)
+                strftime(ref[i], sizeof(ref[i]), _formats[i], &tm);
+            format_exec(&f[i], &tm, out, sizeof(out));
+            if (strcmp(out, ref[i]) && failures++ < 10) {
+                fprintf(stderr, "%s: \"%s\" at %lld: \"%s\", strftime() gives \"%s\"\n",
+                        locale, _formats[i], (long long)t, out, ref[i]);
+            }
+        }
+    }
+
+    return failures;
+}
+
+/**
+ * @brief Start of month @p mon (0-12, 12 being the next January) of TEST_YEAR, in UTC
+ */
+static time_t
+_month_start(int mon)
+{
+    struct tm tm = { .tm_year = TEST_YEAR - 1900, .tm_mon = mon, .tm_mday = 1 };
+
+    return timegm(&tm);
+}
+
+int
+main(int argc, char **argv)
+{
+    int first = 0, last = 11, failures;
+    const char *env;
+
+    if (argc > 1) first = last = atoi(argv[1]) - 1;
+    if (first < 0 || last > 11) {
+        fprintf(stderr, "Usage: %s [MONTH]\n", argv[0]);
+        return 2;
+    }
+
+    failures = _test_locale("C", _month_start(first), _month_start(last + 1));
+
+    // Names come from the locale's tables rather than strftime(), so
+    // check the one the tests run under as well
+    env = setlocale(LC_ALL, "");
+    if (env && strcmp(env, "C") && strcmp(env, "POSIX"))
+        failures += _test_locale(env, _month_start(first), _month_start(last + 1));
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file test_tables.c
+ * @brief Two-digit table against snprintf(), locale names against strftime()
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <locale.h>
+#include <time.h>
+
+#include "tables.h"
+
+static int failures;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    } \
+} while (0)
+
+static void
+_test_digits(void)
+{
+    char out[3] = "", ref[3];
+
+    for (int v = 0; v < 100; v++) {
+        snprintf(ref, sizeof(ref), "%02d", v);
+        CHECK(!memcmp(tables_digits2 + 2 * v, ref, 2));
+
+        tables_num2_put(out, v, '0');
+        CHECK(!strcmp(out, ref));
+
+        snprintf(ref, sizeof(ref), "%2d", v);
+        tables_num2_put(out, v, ' ');
+        CHECK(!strcmp(out, ref));
+    }
+}
+
+static void
+_test_names(const char *locale)
+{
+    static const char *specs[TABLES_NAMES_LAST] = { "%A", "%a", "%B", "%b", "%p" };
+    const Tables_Locale *tl;
+    struct tm tm;
+    char ref[64];
+
+    if (!setlocale(LC_TIME, locale)) return;
+    tl = tables_locale_get();
+
+    // Every hour of 2024-01-01, then every day of 2024
+    for (int i = 0; i < 366 + 23; i++) {
+        time_t t = i < 24 ? 1704067200 + i * 3600 : 1704067200 + (i - 23) * 86400;
+
+        gmtime_r(&t, &tm);
+        for (int n = 0; n < TABLES_NAMES_LAST; n++) {
+            int idx = n == TABLES_NAMES_AMPM ? tm.tm_hour >= 12 :
+                      n <= TABLES_NAMES_WDAY_ABBR ? tm.tm_wday : tm.tm_mon;
+            const Tables_Name *name = &tl->names[n][idx];
+
+            strftime(ref, sizeof(ref), specs[n], &tm);
+            CHECK(name->len == strlen(ref) && !strcmp(name->text, ref));
+        }
+    }
+}
+
+int
+main(void)
+{
+    _test_digits();
+    _test_names("C");
+    _test_names("");
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,150 @@
+/**
+ * @file test_tz.c
+ * @brief tz_localtime() against glibc's localtime_r() under TZ=<zone>
+ *
+ * Every hour from 1950 to 2060 must give the same broken-down time,
+ * offset, DST flag and abbreviation, which covers both the TZif tables
+ * and the POSIX rule past their end. Each reported next instant must be
+ * the first one with another offset, DST flag or abbreviation.
+ *
+ * Takes optional zone names to check instead of the built-in ones.
+ * Exits with 77 (skipped) when none of them can be read.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "tz.h"
+
+#define TEST_START  -631152000LL    // 1950-01-01 00:00:00 UTC
+#define TEST_END    2840140800LL    // 2060-01-01 00:00:00 UTC
+#define TEST_STEP   3600
+
+static const char *_zones[] = {
+    "Europe/London",        // Year-round BST in 1968-1971
+    "America/Santiago",     // Southern hemisphere, rule changes and midnight switches
+    "Australia/Lord_Howe",  // Half-hour DST shift
+};
+
+#define ZONES_COUNT (int)(sizeof(_zones) / sizeof(_zones[0]))
+
+/**
+ * @brief Whether two localtime_r() results have the same local time type
+ */
+static int
+_type_equal(const struct tm *a, const struct tm *b)
+{
+    return a->tm_gmtoff == b->tm_gmtoff && a->tm_isdst == b->tm_isdst &&
+           !strcmp(a->tm_zone, b->tm_zone);
+}
+
+static int
+_tm_equal(const struct tm *a, const struct tm *b)
+{
+    return a->tm_year == b->tm_year && a->tm_mon == b->tm_mon && a->tm_mday == b->tm_mday &&
+           a->tm_hour == b->tm_hour && a->tm_min == b->tm_min && a->tm_sec == b->tm_sec &&
+           a->tm_wday == b->tm_wday && a->tm_yday == b->tm_yday && _type_equal(a, b);
+}
+
+/**
+ * @brief Checks that @p next is where the type in effect at @p t ends
+ */
+static int
+_test_next(const char *zone, time_t t, int64_t next)
+{
+    struct tm at, before, after;
+    time_t n = (time_t)next;
+
+    if (next == TZ_NEVER) return 0;
+    if (next <= t) {
+        fprintf(stderr, "%s: next %lld is not after %lld\n", zone, (long long)next, (long long)t);
+        return 1;
+    }
+
+    localtime_r(&t, &at);
+    n--;
+    localtime_r(&n, &before);
+    n++;
+    localtime_r(&n, &after);
+    if (!_type_equal(&at, &before) || _type_equal(&before, &after)) {
+        fprintf(stderr, "%s: at %lld, next %lld is not a change (%s %ld until then, %s %ld after)\n",
+                zone, (long long)t, (long long)next,
+                before.tm_zone, before.tm_gmtoff, after.tm_zone, after.tm_gmtoff);
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @return Number of failures, or -1 if the zone cannot be read
+ */
+static int
+_test_zone(const char *zone)
+{
+    const Tz_Zone *z = tz_zone_get(zone);
+    int64_t next = INT64_MIN;
+    int failures = 0;
+
+    if (!z) {
+        fprintf(stderr, "Zone %s not available, skipped\n", zone);
+        return -1;
+    }
+
+    setenv("TZ", zone, 1);
+    tzset();
+
+    for (time_t t = TEST_START; t < TEST_END; t += TEST_STEP) {
+        struct tm tm, ref;
+        Tz_Info info;
+
+        tz_localtime(z, t, &tm, &info);
+        localtime_r(&t, &ref);
+
+        if (!_tm_equal(&tm, &ref) || info.utoff != ref.tm_gmtoff || !info.isdst != !ref.tm_isdst ||
+            strcmp(info.abbrev, ref.tm_zone)) {
+            if (failures++ < 10)
+                fprintf(stderr, "%s: at %lld: %04d-%02d-%02d %02d:%02d:%02d %s %d, "
+                        "localtime_r() gives %04d-%02d-%02d %02d:%02d:%02d %s %ld\n",
+                        zone, (long long)t,
+                        tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec,
+                        info.abbrev, info.utoff,
+                        ref.tm_year + 1900, ref.tm_mon + 1, ref.tm_mday, ref.tm_hour, ref.tm_min, ref.tm_sec,
+                        ref.tm_zone, ref.tm_gmtoff);
+        }
+
+        // Only check each period once, from its first sample
+        if (t >= next) {
+            next = info.next;
+            if (_test_next(zone, t, next) && failures++ >= 10) break;
+        } else if (info.next != next && failures++ < 10) {
+            fprintf(stderr, "%s: at %lld, next %lld, earlier in the same period %lld\n",
+                    zone, (long long)t, (long long)info.next, (long long)next);
+        }
+    }
+
+    return failures;
+}
+
+int
+main(int argc, char **argv)
+{
+    int failures = 0, tested = 0;
+
+    for (int i = 0; i < (argc > 1 ? argc - 1 : ZONES_COUNT); i++) {
+        int f = _test_zone(argc > 1 ? argv[i + 1] : _zones[i]);
+
+        if (f < 0) continue;
+        failures += f;
+        tested++;
+    }
+
+    tz_shutdown();
+
+    if (!tested) return 77;
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,163 @@
+/**
+ * @file test_wheel.c
+ * @brief Timing wheel against a brute-force reference, on a fake clock
+ *
+ * Random adds, cancels, advances and backward clock steps are applied
+ * both to the wheel and to a plain array of deadlines. After every
+ * step the earliest deadline and the pending count must agree, and an
+ * advance must fire exactly the timers that were due. Callbacks
+ * re-arm and cancel timers themselves, as the clock's do.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "wheel.h"
+
+#define TEST_TIMERS     1000
+#define TEST_STEPS      100000
+#define TEST_SEC        1000000000LL
+
+typedef struct _Ref {
+    int64_t deadline;
+    Eina_Bool pending;
+    Eina_Bool due;          // Expected to fire in the current advance
+    Eina_Bool fired;
+} Ref;
+
+static Wheel _wheel;
+static Wheel_Timer _timers[TEST_TIMERS];
+static Ref _refs[TEST_TIMERS];
+static int64_t _clock;
+static int failures;
+
+#define CHECK(cond) do { \
+    if (!(cond) && failures++ < 10) fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+} while (0)
+
+static int64_t
+_rand64(void)
+{
+    return ((int64_t)rand() << 31) ^ rand();
+}
+
+static void
+_add(int i, int64_t deadline)
+{
+    wheel_timer_add(&_wheel, &_timers[i], deadline);
+    _refs[i].deadline = deadline;
+    _refs[i].pending = EINA_TRUE;
+}
+
+static void
+_cancel(int i)
+{
+    wheel_timer_cancel(&_wheel, &_timers[i]);
+    _refs[i].pending = EINA_FALSE;
+}
+
+static void
+_timer_cb(void *data, int64_t now)
+{
+    int i = (int)(intptr_t)data;
+    Ref *r = &_refs[i];
+
+    CHECK(now == _clock);
+    CHECK(r->pending && r->deadline <= now && !r->fired);
+    r->pending = EINA_FALSE;
+    r->fired = EINA_TRUE;
+
+    // Cancel another timer, possibly one that is due as well
+    if (rand() % 4 == 0) {
+        int j = rand() % TEST_TIMERS;
+
+        if (_refs[j].pending) _cancel(j);
+    }
+
+    // Re-arm, sometimes for a deadline already passed
+    if (rand() % 3 == 0) _add(i, now + (rand() % 3 ? (int64_t)(rand() % 100000000) : -5));
+}
+
+/**
+ * @brief Earliest pending deadline in the reference
+ */
+static Eina_Bool
+_ref_next(int64_t *deadline)
+{
+    Eina_Bool any = EINA_FALSE;
+
+    for (int i = 0; i < TEST_TIMERS; i++) {
+        if (!_refs[i].pending) continue;
+        if (!any || _refs[i].deadline < *deadline) *deadline = _refs[i].deadline;
+        any = EINA_TRUE;
+    }
+
+    return any;
+}
+
+static void
+_advance(int64_t now)
+{
+    for (int i = 0; i < TEST_TIMERS; i++) {
+        _refs[i].due = _refs[i].pending && _refs[i].deadline <= now;
+        _refs[i].fired = EINA_FALSE;
+    }
+
+    _clock = now;
+    wheel_advance(&_wheel, now);
+
+    // Due timers fired, unless a callback cancelled them first
+    for (int i = 0; i < TEST_TIMERS; i++)
+        CHECK(!_refs[i].due || _refs[i].fired || !_refs[i].pending);
+}
+
+int
+main(int argc, char **argv)
+{
+    static const int64_t spans[] = { TEST_SEC / 1000, TEST_SEC, 86400 * TEST_SEC, 400 * 86400 * TEST_SEC };
+    unsigned int seed = argc > 1 ? (unsigned int)atoi(argv[1]) : 1;
+
+    srand(seed);
+    _clock = 1700000000LL * TEST_SEC;
+    wheel_init(&_wheel, _clock);
+    for (int i = 0; i < TEST_TIMERS; i++)
+        wheel_timer_init(&_timers[i], _timer_cb, (void *)(intptr_t)i);
+
+    for (int step = 0; step < TEST_STEPS; step++) {
+        int op = rand() % 10, i = rand() % TEST_TIMERS;
+        int64_t ref = 0, got = 0;
+        Eina_Bool any;
+        unsigned int pending = 0;
+
+        if (op < 4) {
+            // Anywhere from a millisecond to 400 days out, a few already passed
+            int64_t span = spans[rand() % 4];
+
+            _add(i, _clock - span / 50 + _rand64() % span);
+        } else if (op < 5) {
+            _cancel(i);
+        } else if (op < 9) {
+            any = _ref_next(&ref);
+            CHECK(wheel_next(&_wheel, &got) == any);
+            CHECK(!any || got == ref);
+
+            // Advance to the earliest deadline, sometimes past it
+            if (any && rand() % 2) {
+                int64_t to = ref > _clock ? ref : _clock;
+
+                if (rand() % 3 == 0) to += rand() % TEST_SEC;
+                _advance(to);
+            }
+        } else {
+            // The clock was stepped back
+            _advance(_clock - (rand() % 100000) * TEST_SEC);
+        }
+
+        for (int k = 0; k < TEST_TIMERS; k++) pending += _refs[k].pending;
+        CHECK(pending == _wheel.count);
+    }
+
+    if (failures) fprintf(stderr, "%d failures with seed %u\n", failures, seed);
+
+    return failures ? 1 : 0;
+}